@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <cmath>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include "BandScanner.h"
+#include "ValidRegion.h"
+
+using namespace std::string_literals;
+
+namespace {
+
+// call `scan` with a value of the C++ type matching the data type of the band
+template<typename F>
+Region DispatchDataType(GDALRasterBand *band, F &&scan) {
+  GDALDataType data_type = band->GetRasterDataType();
+  switch (data_type) {
+    case GDT_Byte:return scan(char{});
+    case GDT_Int16:return scan(int16_t{});
+    case GDT_UInt16:return scan(uint16_t{});
+    case GDT_Int32:return scan(int32_t{});
+    case GDT_UInt32:return scan(uint32_t{});
+    case GDT_Float32:return scan(float_t{});
+    case GDT_Float64:return scan(double_t{});
+    default: return {-1, -1, -1, -1};
+  }
+}
+
+// a stripe of block rows of a band
+struct ScanTask {
+  int band_index;
+  int block_y_begin, block_y_end;
+};
+
+// scan the block rows [block_y_begin, block_y_end) of the band returned by GetValidityBand(), cells equal to `nodata`
+// are invalid. Only the full scan is split into block rows, the other modes always scan the whole band.
+Region ScanValidityBand(GDALRasterBand *band,
+                        double nodata,
+                        ScanMode mode,
+                        bool trust_overview,
+                        bool cache_blocks,
+                        int block_y_begin,
+                        int block_y_end) {
+  return DispatchDataType(band, [&](auto type) {
+    using T = decltype(type);
+    switch (mode) {
+      case ScanMode::Edge:return GetTypedBandValidRegionFromEdges<T>(band, nodata);
+      case ScanMode::Overview:return GetTypedBandValidRegionFromOverview<T>(band, nodata, trust_overview);
+      default:return GetTypedBandValidRegion<T>(band, nodata, block_y_begin, block_y_end, cache_blocks);
+    }
+  });
+}
+
+Region ScanStripe(GDALDataset *dataset,
+                  const ScanTask &task,
+                  ScanMode mode,
+                  Validity validity,
+                  bool trust_overview,
+                  bool cache_blocks) {
+  double nodata;
+  auto band = GetValidityBand(dataset->GetRasterBand(task.band_index), validity, &nodata);
+  return ScanValidityBand(band, nodata, mode, trust_overview, cache_blocks, task.block_y_begin, task.block_y_end);
+}
+
+// overview resamplings which only produce nodata when every cell of the footprint is nodata.
+// Nearest (the gdaladdo default) picks a single cell and interpolating kernels are not trusted either.
+bool IsNoDataAwareResampling(const char *resampling) {
+  if (resampling == nullptr) {
+    return false;
+  }
+  for (const char *method: {"AVERAGE", "RMS", "MODE", "MIN", "MAX", "MED", "Q1", "Q3", "SUM"}) {
+    // AVERAGE also covers AVERAGE_MAGPHASE and AVERAGE_BIT2GRAYSCALE
+    if (EQUALN(resampling, method, strlen(method))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template<typename T>
+void ReadWindow(GDALRasterBand *band, int x_off, int y_off, int x_size, int y_size, T *data) {
+  auto err = band->RasterIO(GF_Read,
+                            x_off,
+                            y_off,
+                            x_size,
+                            y_size,
+                            data,
+                            x_size,
+                            y_size,
+                            band->GetRasterDataType(),
+                            0,
+                            0);
+  if (err != CE_None) {
+    throw std::runtime_error("Raster IO Error!");
+  }
+}
+
+}
+
+GDALRasterBand *GetValidityBand(GDALRasterBand *band, Validity validity, double *nodata) {
+  if (validity != Validity::NoData) {
+    int flags = band->GetMaskFlags();
+    if (flags & GMF_ALL_VALID) {
+      return nullptr;
+    }
+    if (!(flags & GMF_NODATA)) {
+      // per dataset mask or alpha band, a byte mask where zero means invalid.
+      // Its own GetNoDataValue() is meaningless and usually out of the byte range.
+      if (nodata != nullptr) {
+        *nodata = 0;
+      }
+      return band->GetMaskBand();
+    }
+    // comparing the data against the nodata value saves building the mask
+  }
+  if (nodata != nullptr) {
+    *nodata = band->GetNoDataValue();
+  }
+  return band;
+}
+
+std::vector<Region> GetBandsValidRegion(GDALDataset *dataset,
+                                        const std::vector<int> &band_indices,
+                                        ScanMode mode,
+                                        int threads,
+                                        Validity validity,
+                                        bool trust_overview,
+                                        bool cache_blocks) {
+  threads = std::max(threads, 1);
+
+  // the full scan splits every band into stripes of block rows, the other modes scan each band as a whole.
+  // Bands without any invalid cell are not scanned.
+  std::vector<ScanTask> tasks;
+  std::vector<bool> all_valid;
+  for (int band_index: band_indices) {
+    auto band = GetValidityBand(dataset->GetRasterBand(band_index), validity);
+    all_valid.push_back(band == nullptr);
+    if (band == nullptr) {
+      continue;
+    }
+    int block_cols, block_rows;
+    band->GetBlockSize(&block_cols, &block_rows);
+    int blocks_y = (band->GetYSize() + block_rows - 1) / block_rows;
+    int stripes = (mode != ScanMode::Full || threads == 1) ? 1 : std::min(blocks_y, threads * 4);
+    int stripe_blocks = (blocks_y + stripes - 1) / stripes;
+    for (int block_y = 0; block_y < blocks_y; block_y += stripe_blocks) {
+      tasks.push_back({band_index, block_y, std::min(blocks_y, block_y + stripe_blocks)});
+    }
+  }
+
+  // no worker without a task, extra workers would only open a dataset handle
+  threads = std::max(1, static_cast<int>(std::min(tasks.size(), static_cast<size_t>(threads))));
+  std::vector<Region> stripe_regions(tasks.size());
+  std::atomic<size_t> next_task{0};
+  std::vector<std::exception_ptr> errors(threads);
+  auto worker = [&](int worker_index) {
+    try {
+      // GDAL datasets must not be shared between threads, every extra worker opens its own handle
+      std::unique_ptr<GDALDataset> own_dataset;
+      GDALDataset *worker_dataset = dataset;
+      if (worker_index != 0) {
+        own_dataset.reset((GDALDataset *) GDALOpen(dataset->GetDescription(), GA_ReadOnly));
+        if (own_dataset == nullptr) {
+          throw std::runtime_error("Failed to open file: "s + dataset->GetDescription());
+        }
+        worker_dataset = own_dataset.get();
+      }
+      for (size_t i = next_task++; i < tasks.size(); i = next_task++) {
+        stripe_regions[i] = ScanStripe(worker_dataset, tasks[i], mode, validity, trust_overview, cache_blocks);
+      }
+    } catch (...) {
+      errors[worker_index] = std::current_exception();
+      next_task = tasks.size();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (int i = 1; i < threads; ++i) {
+    workers.emplace_back(worker, i);
+  }
+  worker(0);
+  for (auto &w: workers) {
+    w.join();
+  }
+  for (const auto &error: errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // merge the stripes of each band, stripes without any valid cell are skipped
+  std::vector<Region> regions;
+  for (size_t j = 0; j != band_indices.size(); ++j) {
+    int band_index = band_indices[j];
+    if (all_valid[j]) {
+      auto band = dataset->GetRasterBand(band_index);
+      regions.emplace_back(0, band->GetYSize() - 1, 0, band->GetXSize() - 1);
+      continue;
+    }
+    std::vector<Region> band_stripe_regions;
+    for (size_t i = 0; i != tasks.size(); ++i) {
+      if (tasks[i].band_index == band_index && stripe_regions[i].Top() != -1) {
+        band_stripe_regions.push_back(stripe_regions[i]);
+      }
+    }
+    if (band_stripe_regions.empty()) {
+      regions.emplace_back(-1, -1, -1, -1);
+    } else {
+      regions.push_back(UnionRegions(band_stripe_regions));
+    }
+  }
+  return regions;
+}
+
+template<typename T>
+Region GetTypedBandValidRegion(GDALRasterBand *band,
+                               double nodata,
+                               int block_y_begin,
+                               int block_y_end,
+                               bool cache_blocks) {
+  int cols = band->GetXSize(), rows = band->GetYSize();
+  int block_cols, block_rows;
+  band->GetBlockSize(&block_cols, &block_rows);
+  std::unique_ptr<T[]> block_data{new T[static_cast<size_t>(block_cols) * block_rows]};
+  ValidRegion<T> region(static_cast<T>(nodata));
+
+  int blocks_x = (cols + block_cols - 1) / block_cols, blocks_y = (rows + block_rows - 1) / block_rows;
+  if (block_y_end < 0 || block_y_end > blocks_y) {
+    block_y_end = blocks_y;
+  }
+  for (int block_y = block_y_begin; block_y < block_y_end; ++block_y) {
+    int y_off = block_y * block_rows;
+    int y_size = std::min(block_rows, rows - y_off);
+    for (int block_x = 0; block_x != blocks_x; ++block_x) {
+      int x_off = block_x * block_cols;
+      int x_size = std::min(block_cols, cols - x_off);
+      // edge blocks are returned as full blocks, only the part inside the raster is used
+      if (cache_blocks) {
+        // the block stays in the block cache of the dataset, a later copy through the same handle reuses it
+        auto block = band->GetLockedBlockRef(block_x, block_y);
+        if (block == nullptr) {
+          throw std::runtime_error("Raster IO Error!");
+        }
+        region.UpdateFromBlock(static_cast<const T *>(block->GetDataRef()), block_cols, x_off, y_off, x_size, y_size);
+        block->DropLock();
+        continue;
+      }
+      auto err = band->ReadBlock(block_x, block_y, block_data.get());
+      if (err != CE_None) {
+        throw std::runtime_error("Raster IO Error!");
+      }
+      region.UpdateFromBlock(block_data.get(), block_cols, x_off, y_off, x_size, y_size);
+    }
+  }
+
+  return region;
+}
+
+template<typename T>
+Region GetTypedBandValidRegionFromEdges(GDALRasterBand *band,
+                                        double nodata,
+                                        int x_begin,
+                                        int y_begin,
+                                        int x_end,
+                                        int y_end) {
+  if (x_end < 0) {
+    x_end = band->GetXSize();
+  }
+  if (y_end < 0) {
+    y_end = band->GetYSize();
+  }
+  int cols = x_end - x_begin;
+  int block_cols, block_rows;
+  band->GetBlockSize(&block_cols, &block_rows);
+  std::unique_ptr<T[]> window_data{new T[static_cast<size_t>(cols) * block_rows]};
+  ValidRegion<T> region(static_cast<T>(nodata));
+  // the window is walked in steps aligned to the block grid of the band
+  auto next_block_row = [&](int y) { return std::min(y_end, (y / block_rows + 1) * block_rows); };
+  auto prev_block_row = [&](int y, int limit) { return std::max(limit, (y - 1) / block_rows * block_rows); };
+
+  // top: block rows from the first row downward
+  int top_end = y_begin;
+  while (top_end < y_end && region.Top() == -1) {
+    int y_next = next_block_row(top_end);
+    ReadWindow(band, x_begin, top_end, cols, y_next - top_end, window_data.get());
+    region.UpdateFromBlock(window_data.get(), cols, x_begin, top_end, cols, y_next - top_end);
+    top_end = y_next;
+  }
+  if (region.Top() == -1) {
+    // no valid cell at all
+    return region;
+  }
+
+  // bottom: block rows from the last row upward, the rows above top_end are already read
+  int bottom_start = y_end;
+  while (bottom_start > top_end && region.Bottom() < bottom_start) {
+    int y_off = prev_block_row(bottom_start, top_end);
+    ReadWindow(band, x_begin, y_off, cols, bottom_start - y_off, window_data.get());
+    region.UpdateFromBlock(window_data.get(), cols, x_begin, y_off, cols, bottom_start - y_off);
+    bottom_start = y_off;
+  }
+
+  // left and right: only the rows between the two scanned borders are still unknown
+  auto scan_column = [&](int x_off, int x_size, auto &&improvable) {
+    for (int y_off = top_end; y_off < bottom_start && improvable();) {
+      int y_next = std::min(bottom_start, next_block_row(y_off));
+      ReadWindow(band, x_off, y_off, x_size, y_next - y_off, window_data.get());
+      region.UpdateFromBlock(window_data.get(), x_size, x_off, y_off, x_size, y_next - y_off);
+      y_off = y_next;
+    }
+  };
+
+  for (int x_off = x_begin; x_off < region.Left();) {
+    int x_next = std::min(x_end, (x_off / block_cols + 1) * block_cols);
+    scan_column(x_off, x_next - x_off, [&]() { return region.Left() > x_off; });
+    x_off = x_next;
+  }
+  for (int x_next = x_end; x_next - 1 > region.Right();) {
+    int x_off = std::max(x_begin, (x_next - 1) / block_cols * block_cols);
+    scan_column(x_off, x_next - x_off, [&]() { return region.Right() < x_next - 1; });
+    x_next = x_off;
+  }
+
+  return region;
+}
+
+template<typename T>
+Region GetTypedBandValidRegionFromOverview(GDALRasterBand *band, double nodata, bool trust_overview) {
+  int has_nodata = 0;
+  band->GetNoDataValue(&has_nodata);
+  GDALRasterBand *overview = nullptr;
+  for (int i = 0; i != band->GetOverviewCount(); ++i) {
+    auto candidate = band->GetOverview(i);
+    if (candidate != nullptr && (overview == nullptr || candidate->GetXSize() < overview->GetXSize())) {
+      overview = candidate;
+    }
+  }
+  // a nearest neighbour overview cell may be nodata although its footprint has valid cells,
+  // an overview without RESAMPLING tag may have been built with nearest
+  if (!has_nodata || overview == nullptr
+      || (!trust_overview && !IsNoDataAwareResampling(overview->GetMetadataItem("RESAMPLING")))) {
+    return GetTypedBandValidRegionFromEdges<T>(band, nodata);
+  }
+
+  Region coarse = GetTypedBandValidRegion<T>(overview, nodata);
+  if (coarse.Top() == -1) {
+    return coarse;
+  }
+  // full resolution window covered by the coarse region, widened by one cell against rounding
+  int cols = band->GetXSize(), rows = band->GetYSize();
+  double x_scale = static_cast<double>(cols) / overview->GetXSize();
+  double y_scale = static_cast<double>(rows) / overview->GetYSize();
+  int x_begin = std::max(0, static_cast<int>(std::floor(coarse.Left() * x_scale)) - 1);
+  int y_begin = std::max(0, static_cast<int>(std::floor(coarse.Top() * y_scale)) - 1);
+  int x_end = std::min(cols, static_cast<int>(std::ceil((coarse.Right() + 1) * x_scale)) + 1);
+  int y_end = std::min(rows, static_cast<int>(std::ceil((coarse.Bottom() + 1) * y_scale)) + 1);
+
+  return GetTypedBandValidRegionFromEdges<T>(band, nodata, x_begin, y_begin, x_end, y_end);
+}
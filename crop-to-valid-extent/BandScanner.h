@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <gdal_priv.h>
+#include "Region.h"
+
+enum class ScanMode {
+  // read every block of the band
+  Full,
+  // search from the four edges inward and stop as soon as a valid cell is found in each direction
+  Edge,
+  // find the valid region on the smallest overview, then search from the edges of the matching full resolution
+  // window. A nodata overview cell has to mean that its whole footprint is nodata, which only holds for resamplings
+  // that skip nodata cells (average, mode, ...). Overviews without such a RESAMPLING tag fall back to Edge unless
+  // they are trusted explicitly.
+  Overview,
+};
+
+enum class Validity {
+  // cells equal to the nodata value of the band are invalid
+  NoData,
+  // cells masked out by GetMaskBand() are invalid, which covers nodata values, alpha bands and per dataset masks.
+  // A band flagged GMF_ALL_VALID is not read at all.
+  Mask,
+};
+
+/**
+ * Return the band whose cells are compared against `*nodata` to tell the valid cells of `band`,
+ * nullptr if all cells are valid. `*nodata` is set to 0 for a mask band and to the nodata value of `band` otherwise.
+ */
+GDALRasterBand *GetValidityBand(GDALRasterBand *band, Validity, double *nodata = nullptr);
+/**
+ * Return the valid region of each band of `band_indices`, computed by `threads` workers.
+ * The full scan splits every band into horizontal stripes of block rows and merges the partial regions
+ * of the stripes, the edge search processes the bands concurrently.
+ * At most one worker per task is started, the first worker uses the given dataset, every other worker opens its
+ * own handle of the same file.
+ * `trust_overview` is passed to GetTypedBandValidRegionFromOverview(), `cache_blocks` to GetTypedBandValidRegion().
+ */
+std::vector<Region> GetBandsValidRegion(GDALDataset *,
+                                        const std::vector<int> &band_indices,
+                                        ScanMode = ScanMode::Full,
+                                        int threads = 1,
+                                        Validity = Validity::NoData,
+                                        bool trust_overview = false,
+                                        bool cache_blocks = false);
+/**
+ * Walk the block rows [block_y_begin, block_y_end) of the band block by block, every block is decoded exactly once.
+ * Cells equal to `nodata` are invalid. A negative `block_y_end` means the last block row.
+ * The blocks are read with ReadBlock(), which bypasses the block cache, unless `cache_blocks` is set: then they are
+ * read through GetLockedBlockRef() and stay cached for a later copy of the raster through the same handle.
+ */
+template<typename T>
+Region GetTypedBandValidRegion(GDALRasterBand *,
+                               double nodata,
+                               int block_y_begin = 0,
+                               int block_y_end = -1,
+                               bool cache_blocks = false);
+/**
+ * Read the top and bottom block rows of the window [x_begin, x_end) x [y_begin, y_end) until a valid cell is found,
+ * then the left and right block columns of the remaining rows until a valid cell is found. Only the blank border
+ * and the first block row/column containing data in each direction is read.
+ * Cells equal to `nodata` are invalid. A negative `x_end`/`y_end` means the width/height of the band.
+ */
+template<typename T>
+Region GetTypedBandValidRegionFromEdges(GDALRasterBand *,
+                                        double nodata,
+                                        int x_begin = 0,
+                                        int y_begin = 0,
+                                        int x_end = -1,
+                                        int y_end = -1);
+/**
+ * Coarse to fine search, see ScanMode::Overview. Falls back to the edge search if the band has no nodata value,
+ * no overview, or an overview whose RESAMPLING metadata does not name a resampling skipping nodata cells
+ * (a missing tag included, gdaladdo defaults to nearest). `trust_overview` skips the RESAMPLING check.
+ */
+template<typename T>
+Region GetTypedBandValidRegionFromOverview(GDALRasterBand *, double nodata, bool trust_overview = false);
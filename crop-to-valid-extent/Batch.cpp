@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Batch.h"
+
+namespace {
+
+std::string JsonString(const std::string &str) {
+  std::ostringstream out;
+  out << '"';
+  for (char c: str) {
+    switch (c) {
+      case '"':out << "\\\"";
+        break;
+      case '\\':out << "\\\\";
+        break;
+      case '\n':out << "\\n";
+        break;
+      case '\r':out << "\\r";
+        break;
+      case '\t':out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out << "\\u00" << "0123456789abcdef"[c >> 4] << "0123456789abcdef"[c & 0xF];
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+  return out.str();
+}
+
+std::string CsvString(const std::string &str) {
+  std::string quoted{'"'};
+  for (char c: str) {
+    if (c == '"') {
+      quoted += '"';
+    }
+    quoted += c;
+  }
+  return quoted + '"';
+}
+
+std::string JsonSrcWin(const Region &region) {
+  if (!region.IsValid()) {
+    return "null";
+  }
+  auto src_win = region.GDALTranslateSrcWin();
+  return "[" + std::to_string(src_win[0]) + "," + std::to_string(src_win[1]) + "," + std::to_string(src_win[2]) + ","
+      + std::to_string(src_win[3]) + "]";
+}
+
+std::string FormatJson(const std::string &raster, const RasterValidRegion *result, const std::string &error) {
+  std::string line = "{\"raster\":" + JsonString(raster);
+  if (result == nullptr) {
+    return line + ",\"error\":" + JsonString(error) + "}";
+  }
+  line += ",\"srcwin\":" + JsonSrcWin(result->region) + ",\"bands\":[";
+  for (size_t i = 0; i != result->band_regions.size(); ++i) {
+    if (i != 0) {
+      line += ",";
+    }
+    line += "{\"band\":" + std::to_string(result->band_indices[i]) + ",\"srcwin\":"
+        + JsonSrcWin(result->band_regions[i]) + "}";
+  }
+  return line + "]}";
+}
+
+// srcwin fields are left empty for regions without any valid cell
+std::string CsvSrcWin(const Region &region, char separator) {
+  if (!region.IsValid()) {
+    return std::string(3, separator);
+  }
+  auto src_win = region.GDALTranslateSrcWin();
+  return std::to_string(src_win[0]) + separator + std::to_string(src_win[1]) + separator + std::to_string(src_win[2])
+      + separator + std::to_string(src_win[3]);
+}
+
+std::string FormatCsv(const std::string &raster, const RasterValidRegion *result, const std::string &error) {
+  std::string line = CsvString(raster) + ",";
+  if (result == nullptr) {
+    return line + ",,,,," + CsvString(error);
+  }
+  // band regions as "band:xoff yoff xsize ysize" separated by ';'
+  std::string bands;
+  for (size_t i = 0; i != result->band_regions.size(); ++i) {
+    if (i != 0) {
+      bands += ";";
+    }
+    bands += std::to_string(result->band_indices[i]) + ":";
+    if (result->band_regions[i].IsValid()) {
+      bands += CsvSrcWin(result->band_regions[i], ' ');
+    }
+  }
+  return line + CsvSrcWin(result->region, ',') + "," + CsvString(bands) + ",";
+}
+
+// next non-blank line of `rasters` without trailing whitespace, false at the end of the input
+bool ReadRasterPath(std::istream &rasters, std::string &path) {
+  for (std::string line; std::getline(rasters, line);) {
+    auto end = line.find_last_not_of(" \t\r");
+    if (end != std::string::npos) {
+      path = line.substr(0, end + 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+}
+
+int RunBatch(std::istream &rasters, std::ostream &out, RasterValidRegionOptions options, BatchFormat format) {
+  auto format_line = format == BatchFormat::Json ? FormatJson : FormatCsv;
+  if (format == BatchFormat::Csv) {
+    out << "raster,xoff,yoff,xsize,ysize,bands,error\n";
+  }
+
+  // the rasters are spread over the workers, the bands of one raster are scanned by a single thread
+  int threads = std::max(options.threads, 1);
+  options.threads = 1;
+  // the paths are read while the workers run, results finished ahead of an earlier raster wait in `pending`.
+  // A worker takes no new path while `window` rasters are read but not written yet, which bounds `pending`.
+  const size_t window = 4 * static_cast<size_t>(threads);
+  std::mutex mutex;
+  std::condition_variable line_written;
+  size_t next_raster = 0;
+  size_t next_line = 0;
+  std::map<size_t, std::string> pending;
+  std::atomic<int> failures{0};
+  auto worker = [&]() {
+    for (;;) {
+      std::string path;
+      size_t index;
+      {
+        std::unique_lock<std::mutex> lock{mutex};
+        line_written.wait(lock, [&]() { return next_raster - next_line < window; });
+        if (!ReadRasterPath(rasters, path)) {
+          return;
+        }
+        index = next_raster++;
+      }
+      std::string line;
+      try {
+        auto result = GetRasterValidRegion(path, options);
+        line = format_line(path, &result, "");
+      } catch (const std::exception &e) {
+        ++failures;
+        line = format_line(path, nullptr, e.what());
+      }
+      {
+        // results are written as soon as all the previous ones are written
+        std::lock_guard<std::mutex> lock{mutex};
+        pending.emplace(index, std::move(line));
+        for (auto it = pending.begin(); it != pending.end() && it->first == next_line; ++next_line) {
+          out << it->second << '\n';
+          it = pending.erase(it);
+        }
+      }
+      line_written.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (int i = 1; i < threads; ++i) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (auto &w: workers) {
+    w.join();
+  }
+  out.flush();
+
+  return failures;
+}
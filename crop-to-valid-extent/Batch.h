@@ -0,0 +1,20 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include "RasterValidRegion.h"
+
+enum class BatchFormat {
+  // one JSON object per line
+  Json,
+  // a header line followed by one record per raster
+  Csv,
+};
+
+/**
+ * Read one raster path per line from `rasters` and write one result line per raster to `out`, in input order.
+ * `options.threads` rasters are processed at the same time, each of them by a single thread. The paths are read
+ * while the rasters are processed, so the first results are written before the end of `rasters` is reached.
+ * Returns the number of rasters which failed, their result line carries the error message.
+ */
+int RunBatch(std::istream &rasters, std::ostream &out, RasterValidRegionOptions options, BatchFormat format);
@@ -0,0 +1,82 @@
+#include <stdexcept>
+#include <cpl_string.h>
+#include <vrtdataset.h>
+#include "Crop.h"
+
+using namespace std::string_literals;
+
+std::unique_ptr<GDALDataset> CreateCroppedVRT(GDALDataset *dataset, const Region &region, const std::string &vrt_path) {
+  if (!region.IsValid()) {
+    throw std::runtime_error("Region is invalid, nothing to crop");
+  }
+  auto src_win = region.GDALTranslateSrcWin();
+  int x_off = src_win[0], y_off = src_win[1], x_size = src_win[2], y_size = src_win[3];
+
+  std::unique_ptr<GDALDataset> vrt;
+  if (vrt_path.empty()) {
+    vrt.reset(new VRTDataset(x_size, y_size));
+  } else {
+    auto driver = GetGDALDriverManager()->GetDriverByName("VRT");
+    vrt.reset(driver->Create(vrt_path.c_str(), x_size, y_size, 0, GDT_Unknown, nullptr));
+    if (vrt == nullptr) {
+      throw std::runtime_error("Failed to create file: "s + vrt_path);
+    }
+  }
+  double geo_transform[6];
+  if (dataset->GetGeoTransform(geo_transform) == CE_None) {
+    geo_transform[0] += x_off * geo_transform[1] + y_off * geo_transform[2];
+    geo_transform[3] += x_off * geo_transform[4] + y_off * geo_transform[5];
+    vrt->SetGeoTransform(geo_transform);
+  }
+  vrt->SetProjection(dataset->GetProjectionRef());
+
+  for (int i = 1; i <= dataset->GetRasterCount(); ++i) {
+    auto src_band = dataset->GetRasterBand(i);
+    vrt->AddBand(src_band->GetRasterDataType(), nullptr);
+    auto band = (VRTSourcedRasterBand *) vrt->GetRasterBand(i);
+    band->AddSimpleSource(src_band, x_off, y_off, x_size, y_size, 0, 0, x_size, y_size);
+
+    int has_nodata = FALSE;
+    double nodata = src_band->GetNoDataValue(&has_nodata);
+    if (has_nodata) {
+      band->SetNoDataValue(nodata);
+    }
+    band->SetColorInterpretation(src_band->GetColorInterpretation());
+    if (src_band->GetColorTable() != nullptr) {
+      band->SetColorTable(src_band->GetColorTable());
+    }
+  }
+
+  return vrt;
+}
+
+void WriteCroppedVRT(GDALDataset *dataset, const Region &region, const std::string &vrt_path) {
+  // the XML is written when the VRT is closed
+  CreateCroppedVRT(dataset, region, vrt_path).reset();
+}
+
+void WriteCroppedRaster(GDALDataset *dataset,
+                        const Region &region,
+                        const std::string &output,
+                        const std::string &format,
+                        const std::vector<std::string> &creation_options) {
+  if (EQUAL(format.c_str(), "VRT")) {
+    WriteCroppedVRT(dataset, region, output);
+    return;
+  }
+  auto driver = GetGDALDriverManager()->GetDriverByName(format.c_str());
+  if (driver == nullptr) {
+    throw std::runtime_error("Unknown raster format: "s + format);
+  }
+  auto vrt = CreateCroppedVRT(dataset, region);
+
+  CPLStringList options;
+  for (const auto &option: creation_options) {
+    options.AddString(option.c_str());
+  }
+  std::unique_ptr<GDALDataset> cropped{
+      driver->CreateCopy(output.c_str(), vrt.get(), FALSE, options.List(), GDALDummyProgress, nullptr)};
+  if (cropped == nullptr) {
+    throw std::runtime_error("Failed to create file: "s + output);
+  }
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <gdal_priv.h>
+#include "Region.h"
+
+/**
+ * Create a VRT of `region` of the dataset. Every band references the matching source band window,
+ * the geotransform is shifted to the region and the projection, nodata values and color interpretations are kept.
+ * The VRT is kept in memory if `vrt_path` is empty, otherwise it is written to `vrt_path` when it is closed.
+ */
+std::unique_ptr<GDALDataset> CreateCroppedVRT(GDALDataset *, const Region &, const std::string &vrt_path = "");
+/**
+ * Write `region` of the dataset to a VRT file referencing the source pixels, no pixel is copied.
+ * Throws std::runtime_error on failure.
+ */
+void WriteCroppedVRT(GDALDataset *, const Region &, const std::string &vrt_path);
+/**
+ * Write `region` of the dataset to `output` with the driver `format` (e.g. GTiff), the VRT format is written
+ * by WriteCroppedVRT.
+ * The pixels are copied through the VRT of CreateCroppedVRT, blocks still in the block cache of the dataset
+ * (e.g. read by the edge or overview search) are not decoded again. Throws std::runtime_error on failure.
+ */
+void WriteCroppedRaster(GDALDataset *,
+                        const Region &,
+                        const std::string &output,
+                        const std::string &format,
+                        const std::vector<std::string> &creation_options);
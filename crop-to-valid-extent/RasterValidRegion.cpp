@@ -0,0 +1,51 @@
+#include <memory>
+#include <stdexcept>
+#include <gdal_priv.h>
+#include "RasterValidRegion.h"
+
+using namespace std::string_literals;
+
+std::unique_ptr<GDALDataset> OpenRaster(const std::string &raster) {
+  std::unique_ptr<GDALDataset> dataset{(GDALDataset *) GDALOpen(raster.c_str(), GA_ReadOnly)};
+  if (dataset == nullptr) {
+    throw std::runtime_error("Failed to open file: "s + raster);
+  }
+  return dataset;
+}
+
+RasterValidRegion GetRasterValidRegion(const std::string &raster, const RasterValidRegionOptions &options) {
+  auto dataset = OpenRaster(raster);
+  return GetRasterValidRegion(dataset.get(), options);
+}
+
+RasterValidRegion GetRasterValidRegion(GDALDataset *dataset, const RasterValidRegionOptions &options) {
+  int band_number = dataset->GetRasterCount();
+  if (band_number == 0 || options.band_index < 0 || options.band_index > band_number) {
+    throw std::runtime_error("Invalid Band: "s + std::to_string(options.band_index));
+  }
+
+  RasterValidRegion result;
+  if (options.band_index != 0) {
+    result.band_indices.push_back(options.band_index);
+  } else {
+    for (int i = 1; i <= band_number; ++i) {
+      result.band_indices.push_back(i);
+    }
+  }
+  result.band_regions = GetBandsValidRegion(dataset,
+                                            result.band_indices,
+                                            options.scan_mode,
+                                            options.threads,
+                                            options.validity,
+                                            options.trust_overview,
+                                            options.cache_blocks);
+
+  if (result.band_regions.size() == 1) {
+    result.region = result.band_regions[0];
+  } else if (options.union_region) {
+    result.region = UnionRegions(result.band_regions);
+  } else {
+    result.region = IntersectRegions(result.band_regions);
+  }
+  return result;
+}
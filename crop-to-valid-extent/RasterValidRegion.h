@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <gdal_priv.h>
+#include "BandScanner.h"
+#include "Region.h"
+
+struct RasterValidRegionOptions {
+  // zero means all bands
+  int band_index{0};
+  // merge the band regions by union instead of intersection
+  bool union_region{false};
+  ScanMode scan_mode{ScanMode::Full};
+  // use the overview of ScanMode::Overview whatever its RESAMPLING metadata says
+  bool trust_overview{false};
+  Validity validity{Validity::NoData};
+  int threads{1};
+  // read the full scan through the block cache, so that a copy of the raster from the same dataset handle
+  // (e.g. WriteCroppedRaster) does not read the blocks from disk again
+  bool cache_blocks{false};
+};
+
+struct RasterValidRegion {
+  // the merged region of all scanned bands
+  Region region;
+  std::vector<int> band_indices;
+  std::vector<Region> band_regions;
+};
+
+/**
+ * Open the raster read-only, throws std::runtime_error on failure.
+ */
+std::unique_ptr<GDALDataset> OpenRaster(const std::string &raster);
+/**
+ * Open the raster and compute the valid region of the band(s) selected by the options.
+ * Throws std::runtime_error if the raster can not be opened or the band index is invalid.
+ */
+RasterValidRegion GetRasterValidRegion(const std::string &raster, const RasterValidRegionOptions &);
+RasterValidRegion GetRasterValidRegion(GDALDataset *, const RasterValidRegionOptions &);
@@ -6,7 +6,16 @@
 Region::Region(int top, int bottom, int left, int right) : top{top}, bottom{bottom}, left{left}, right{right} {}
 
 void Region::PrintGDALTranslateSrcWin() const {
-  std::cout << left << " " << top << " " << (right - left + 1) << " " << (bottom - top + 1) << std::endl;
+  auto src_win = GDALTranslateSrcWin();
+  std::cout << src_win[0] << " " << src_win[1] << " " << src_win[2] << " " << src_win[3] << std::endl;
+}
+
+std::array<int, 4> Region::GDALTranslateSrcWin() const noexcept {
+  return {left, top, right - left + 1, bottom - top + 1};
+}
+
+bool Region::IsValid() const noexcept {
+  return top > -1 && left > -1 && bottom >= top && right >= left;
 }
 
 void Region::Union(int &a_top, int &a_bottom, int &a_left, int &a_right) const {
@@ -45,7 +54,10 @@ Region UnionRegions(const std::vector<Region> &regions) {
 
   int top{kIntMax}, bottom{kIntLowest}, left{kIntMax}, right{kIntLowest};
   for (const auto &region: regions) {
-    region.Union(top, bottom, left, right);
+    // a region without any valid cell does not extend the union
+    if (region.IsValid()) {
+      region.Union(top, bottom, left, right);
+    }
   }
 
   return {top, bottom, left, right};
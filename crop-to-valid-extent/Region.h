@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <vector>
 
 class Region {
@@ -7,8 +8,16 @@ class Region {
   Region();
   Region(int top, int bottom, int left, int right);
   void PrintGDALTranslateSrcWin() const;
+  // xoff, yoff, xsize, ysize
+  [[nodiscard]] std::array<int, 4> GDALTranslateSrcWin() const noexcept;
+  // at least one valid cell
+  [[nodiscard]] bool IsValid() const noexcept;
   void Union(int &, int &, int &, int &) const;
   void Intersect(int &, int &, int &, int &) const;
+  [[nodiscard]] int Top() const noexcept { return top; }
+  [[nodiscard]] int Bottom() const noexcept { return bottom; }
+  [[nodiscard]] int Left() const noexcept { return left; }
+  [[nodiscard]] int Right() const noexcept { return right; }
 
  protected:
   // the first index of line or column which contains at least one valid cell in each direction
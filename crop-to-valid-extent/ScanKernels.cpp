@@ -0,0 +1,306 @@
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include "ScanKernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_KERNELS_X86
+#include <immintrin.h>
+#define SCAN_TARGET_SSE2 __attribute__((target("sse2")))
+#define SCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#define SCAN_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+
+namespace {
+
+template<typename T>
+inline bool NoDataIsNaN(T nodata) noexcept {
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::isnan(nodata);
+  } else {
+    return false;
+  }
+}
+
+template<typename T>
+inline bool ValueIsValid(T value, T nodata, bool nodata_is_nan) noexcept {
+  if constexpr (std::is_floating_point_v<T>) {
+    if (nodata_is_nan) {
+      return !std::isnan(value);
+    }
+  }
+  return value != nodata;
+}
+
+template<typename T>
+int FindFirstValidScalar(const T *array, int begin, int end, T nodata) noexcept {
+  bool nodata_is_nan = NoDataIsNaN(nodata);
+  for (int i = begin; i < end; ++i) {
+    if (ValueIsValid(array[i], nodata, nodata_is_nan)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+template<typename T>
+int FindLastValidScalar(const T *array, int begin, int end, T nodata) noexcept {
+  bool nodata_is_nan = NoDataIsNaN(nodata);
+  for (int i = end - 1; i >= begin; --i) {
+    if (ValueIsValid(array[i], nodata, nodata_is_nan)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+#ifdef SCAN_KERNELS_X86
+
+enum class Isa { Sse2, Avx2, Avx512 };
+
+Isa DetectIsa() noexcept {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    return Isa::Avx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return Isa::Avx2;
+  }
+  return Isa::Sse2;
+}
+
+const Isa kIsa = DetectIsa();
+
+// nodata value copied into every lane, the bits of floating point values are kept as they are
+template<typename T>
+SCAN_TARGET_SSE2 inline __m128i BroadcastSse2(T nodata) noexcept {
+  if constexpr (std::is_same_v<T, float>) {
+    return _mm_castps_si128(_mm_set1_ps(nodata));
+  } else if constexpr (std::is_same_v<T, double>) {
+    return _mm_castpd_si128(_mm_set1_pd(nodata));
+  } else if constexpr (sizeof(T) == 1) {
+    return _mm_set1_epi8(static_cast<char>(nodata));
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm_set1_epi16(static_cast<int16_t>(nodata));
+  } else {
+    return _mm_set1_epi32(static_cast<int32_t>(nodata));
+  }
+}
+
+// one bit per byte, set for the bytes of valid cells
+template<typename T>
+SCAN_TARGET_SSE2 inline uint32_t ValidBytesSse2(const T *array, __m128i nodata, bool nodata_is_nan) noexcept {
+  __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(array));
+  __m128i invalid;
+  if constexpr (std::is_same_v<T, float>) {
+    __m128 v = _mm_castsi128_ps(values);
+    invalid = _mm_castps_si128(nodata_is_nan ? _mm_cmpunord_ps(v, v) : _mm_cmpeq_ps(v, _mm_castsi128_ps(nodata)));
+  } else if constexpr (std::is_same_v<T, double>) {
+    __m128d v = _mm_castsi128_pd(values);
+    invalid = _mm_castpd_si128(nodata_is_nan ? _mm_cmpunord_pd(v, v) : _mm_cmpeq_pd(v, _mm_castsi128_pd(nodata)));
+  } else if constexpr (sizeof(T) == 1) {
+    invalid = _mm_cmpeq_epi8(values, nodata);
+  } else if constexpr (sizeof(T) == 2) {
+    invalid = _mm_cmpeq_epi16(values, nodata);
+  } else {
+    invalid = _mm_cmpeq_epi32(values, nodata);
+  }
+  return ~static_cast<uint32_t>(_mm_movemask_epi8(invalid)) & 0xFFFFu;
+}
+
+template<typename T>
+SCAN_TARGET_SSE2 int FindFirstValidSse2(const T *array, int len, T nodata) noexcept {
+  constexpr int kStep = 16 / sizeof(T);
+  bool nodata_is_nan = NoDataIsNaN(nodata);
+  __m128i nodata_vec = BroadcastSse2(nodata);
+  int i = 0;
+  for (; i + kStep <= len; i += kStep) {
+    uint32_t valid = ValidBytesSse2(array + i, nodata_vec, nodata_is_nan);
+    if (valid != 0) {
+      return i + __builtin_ctz(valid) / static_cast<int>(sizeof(T));
+    }
+  }
+  return FindFirstValidScalar(array, i, len, nodata);
+}
+
+template<typename T>
+SCAN_TARGET_SSE2 int FindLastValidSse2(const T *array, int len, T nodata) noexcept {
+  constexpr int kStep = 16 / sizeof(T);
+  bool nodata_is_nan = NoDataIsNaN(nodata);
+  __m128i nodata_vec = BroadcastSse2(nodata);
+  int i = len;
+  for (; i - kStep >= 0; i -= kStep) {
+    uint32_t valid = ValidBytesSse2(array + i - kStep, nodata_vec, nodata_is_nan);
+    if (valid != 0) {
+      return i - kStep + (31 - __builtin_clz(valid)) / static_cast<int>(sizeof(T));
+    }
+  }
+  return FindLastValidScalar(array, 0, i, nodata);
+}
+
+template<typename T>
+SCAN_TARGET_AVX2 inline __m256i BroadcastAvx2(T nodata) noexcept {
+  if constexpr (std::is_same_v<T, float>) {
+    return _mm256_castps_si256(_mm256_set1_ps(nodata));
+  } else if constexpr (std::is_same_v<T, double>) {
+    return _mm256_castpd_si256(_mm256_set1_pd(nodata));
+  } else if constexpr (sizeof(T) == 1) {
+    return _mm256_set1_epi8(static_cast<char>(nodata));
+  } else if constexpr (sizeof(T) == 2) {
+    return _mm256_set1_epi16(static_cast<int16_t>(nodata));
+  } else {
+    return _mm256_set1_epi32(static_cast<int32_t>(nodata));
+  }
+}
+
+// one bit per byte, set for the bytes of valid cells
+template<typename T>
+SCAN_TARGET_AVX2 inline uint32_t ValidBytesAvx2(const T *array, __m256i nodata, bool nodata_is_nan) noexcept {
+  __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(array));
+  __m256i invalid;
+  if constexpr (std::is_same_v<T, float>) {
+    __m256 v = _mm256_castsi256_ps(values);
+    invalid = _mm256_castps_si256(nodata_is_nan ? _mm256_cmp_ps(v, v, _CMP_UNORD_Q)
+                                                : _mm256_cmp_ps(v, _mm256_castsi256_ps(nodata), _CMP_EQ_OQ));
+  } else if constexpr (std::is_same_v<T, double>) {
+    __m256d v = _mm256_castsi256_pd(values);
+    invalid = _mm256_castpd_si256(nodata_is_nan ? _mm256_cmp_pd(v, v, _CMP_UNORD_Q)
+                                                : _mm256_cmp_pd(v, _mm256_castsi256_pd(nodata), _CMP_EQ_OQ));
+  } else if constexpr (sizeof(T) == 1) {
+    invalid = _mm256_cmpeq_epi8(values, nodata);
+  } else if constexpr (sizeof(T) == 2) {
+    invalid = _mm256_cmpeq_epi16(values, nodata);
+  } else {
+    invalid = _mm256_cmpeq_epi32(values, nodata);
+  }
+  return ~static_cast<uint32_t>(_mm256_movemask_epi8(invalid));
+}
+
+template<typename T>
+SCAN_TARGET_AVX2 int FindFirstValidAvx2(const T *array, int len, T nodata) noexcept {
+  constexpr int kStep = 32 / sizeof(T);
+  bool nodata_is_nan = NoDataIsNaN(nodata);
+  __m256i nodata_vec = BroadcastAvx2(nodata);
+  int i = 0;
+  for (; i + kStep <= len; i += kStep) {
+    uint32_t valid = ValidBytesAvx2(array + i, nodata_vec, nodata_is_nan);
+    if (valid != 0) {
+      return i + __builtin_ctz(valid) / static_cast<int>(sizeof(T));
+    }
+  }
+  return FindFirstValidScalar(array, i, len, nodata);
+}
+
+template<typename T>
+SCAN_TARGET_AVX2 int FindLastValidAvx2(const T *array, int len, T nodata) noexcept {
+  constexpr int kStep = 32 / sizeof(T);
+  bool nodata_is_nan = NoDataIsNaN(nodata);
+  __m256i nodata_vec = BroadcastAvx2(nodata);
+  int i = len;
+  for (; i - kStep >= 0; i -= kStep) {
+    uint32_t valid = ValidBytesAvx2(array + i - kStep, nodata_vec, nodata_is_nan);
+    if (valid != 0) {
+      return i - kStep + (31 - __builtin_clz(valid)) / static_cast<int>(sizeof(T));
+    }
+  }
+  return FindLastValidScalar(array, 0, i, nodata);
+}
+
+// one bit per cell, set for valid cells
+template<typename T>
+SCAN_TARGET_AVX512 inline uint64_t ValidCellsAvx512(const T *array, T nodata, bool nodata_is_nan) noexcept {
+  if constexpr (std::is_same_v<T, float>) {
+    __m512 v = _mm512_loadu_ps(array);
+    __mmask16 invalid = nodata_is_nan ? _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q)
+                                      : _mm512_cmp_ps_mask(v, _mm512_set1_ps(nodata), _CMP_EQ_OQ);
+    return static_cast<uint16_t>(~invalid);
+  } else if constexpr (std::is_same_v<T, double>) {
+    __m512d v = _mm512_loadu_pd(array);
+    __mmask8 invalid = nodata_is_nan ? _mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q)
+                                     : _mm512_cmp_pd_mask(v, _mm512_set1_pd(nodata), _CMP_EQ_OQ);
+    return static_cast<uint8_t>(~invalid);
+  } else {
+    __m512i v = _mm512_loadu_si512(array);
+    if constexpr (sizeof(T) == 1) {
+      return ~static_cast<uint64_t>(_mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(static_cast<char>(nodata))));
+    } else if constexpr (sizeof(T) == 2) {
+      return static_cast<uint32_t>(~_mm512_cmpeq_epi16_mask(v, _mm512_set1_epi16(static_cast<int16_t>(nodata))));
+    } else {
+      return static_cast<uint16_t>(~_mm512_cmpeq_epi32_mask(v, _mm512_set1_epi32(static_cast<int32_t>(nodata))));
+    }
+  }
+}
+
+template<typename T>
+SCAN_TARGET_AVX512 int FindFirstValidAvx512(const T *array, int len, T nodata) noexcept {
+  constexpr int kStep = 64 / sizeof(T);
+  bool nodata_is_nan = NoDataIsNaN(nodata);
+  int i = 0;
+  for (; i + kStep <= len; i += kStep) {
+    uint64_t valid = ValidCellsAvx512(array + i, nodata, nodata_is_nan);
+    if (valid != 0) {
+      return i + __builtin_ctzll(valid);
+    }
+  }
+  return FindFirstValidScalar(array, i, len, nodata);
+}
+
+template<typename T>
+SCAN_TARGET_AVX512 int FindLastValidAvx512(const T *array, int len, T nodata) noexcept {
+  constexpr int kStep = 64 / sizeof(T);
+  bool nodata_is_nan = NoDataIsNaN(nodata);
+  int i = len;
+  for (; i - kStep >= 0; i -= kStep) {
+    uint64_t valid = ValidCellsAvx512(array + i - kStep, nodata, nodata_is_nan);
+    if (valid != 0) {
+      return i - kStep + (63 - __builtin_clzll(valid));
+    }
+  }
+  return FindLastValidScalar(array, 0, i, nodata);
+}
+
+#endif
+
+}
+
+template<typename T>
+int FindFirstValid(const T *array, int len, T nodata) noexcept {
+#ifdef SCAN_KERNELS_X86
+  switch (kIsa) {
+    case Isa::Avx512:return FindFirstValidAvx512(array, len, nodata);
+    case Isa::Avx2:return FindFirstValidAvx2(array, len, nodata);
+    default:return FindFirstValidSse2(array, len, nodata);
+  }
+#else
+  return FindFirstValidScalar(array, 0, len, nodata);
+#endif
+}
+
+template<typename T>
+int FindLastValid(const T *array, int len, T nodata) noexcept {
+#ifdef SCAN_KERNELS_X86
+  switch (kIsa) {
+    case Isa::Avx512:return FindLastValidAvx512(array, len, nodata);
+    case Isa::Avx2:return FindLastValidAvx2(array, len, nodata);
+    default:return FindLastValidSse2(array, len, nodata);
+  }
+#else
+  return FindLastValidScalar(array, 0, len, nodata);
+#endif
+}
+
+template int FindFirstValid<char>(const char *, int, char) noexcept;
+template int FindFirstValid<int16_t>(const int16_t *, int, int16_t) noexcept;
+template int FindFirstValid<uint16_t>(const uint16_t *, int, uint16_t) noexcept;
+template int FindFirstValid<int32_t>(const int32_t *, int, int32_t) noexcept;
+template int FindFirstValid<uint32_t>(const uint32_t *, int, uint32_t) noexcept;
+template int FindFirstValid<float_t>(const float_t *, int, float_t) noexcept;
+template int FindFirstValid<double_t>(const double_t *, int, double_t) noexcept;
+
+template int FindLastValid<char>(const char *, int, char) noexcept;
+template int FindLastValid<int16_t>(const int16_t *, int, int16_t) noexcept;
+template int FindLastValid<uint16_t>(const uint16_t *, int, uint16_t) noexcept;
+template int FindLastValid<int32_t>(const int32_t *, int, int32_t) noexcept;
+template int FindLastValid<uint32_t>(const uint32_t *, int, uint32_t) noexcept;
+template int FindLastValid<float_t>(const float_t *, int, float_t) noexcept;
+template int FindLastValid<double_t>(const double_t *, int, double_t) noexcept;
@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+ * Valid cell search kernels used by ValidRegion.
+ *
+ * A cell is invalid if it equals the nodata value, or if it is NaN when the nodata value is NaN.
+ * On x86 the widest available instruction set (SSE2/AVX2/AVX-512) is picked at runtime.
+ */
+
+// index of the first valid cell of the line, -1 if the line has no valid cell
+template<typename T>
+int FindFirstValid(const T *, int len, T nodata) noexcept;
+// index of the last valid cell of the line, -1 if the line has no valid cell
+template<typename T>
+int FindLastValid(const T *, int len, T nodata) noexcept;
@@ -1,41 +1,43 @@
 #include <iostream>
 #include "ValidRegion.h"
+#include "ScanKernels.h"
 
 template<typename T>
 ValidRegion<T>::ValidRegion(): ValidRegion(0) {}
 
 template<typename T>
-ValidRegion<T>::ValidRegion(T nodata): Region(-1, -1, -1, -1), nodata{nodata}, line_index{-1} {}
+ValidRegion<T>::ValidRegion(T nodata): Region(-1, -1, -1, -1), nodata{nodata} {}
 
 template<typename T>
-void ValidRegion<T>::UpdateFromLine(T *array, int len) noexcept {
-  int index_leftmost_valid{-1}, index_rightmost_valid{len};
-  // find the index of the left most valid cell and the right most valid cell
-  for (int i = 0; i != len; ++i) {
-    T value = array[i];
-    if (ValueIsValid(value)) {
-      if (index_leftmost_valid == -1) {
-        index_leftmost_valid = i;
-      }
-      index_rightmost_valid = i;
+void ValidRegion<T>::UpdateFromBlock(const T *block,
+                                     int block_x_size,
+                                     int x_off,
+                                     int y_off,
+                                     int x_size,
+                                     int y_size) noexcept {
+  for (int i = 0; i != y_size; ++i) {
+    const T *line = block + static_cast<size_t>(i) * block_x_size;
+    int index_leftmost_valid = FindFirstValid(line, x_size, nodata);
+    if (index_leftmost_valid != -1) {
+      UpdateRow(y_off + i, x_off + index_leftmost_valid, x_off + FindLastValid(line, x_size, nodata));
     }
   }
+}
 
-  ++line_index;
-  // update the global row/column index
-  if (index_leftmost_valid != -1) {
-    //  this line has at least one valid cell
-
-    if (top == -1) {
-      top = line_index;
-    }
-    bottom = line_index;
-    if (index_leftmost_valid < left || left == -1) {
-      left = index_leftmost_valid;
-    }
-    if (index_rightmost_valid > right || right == -1) {
-      right = index_rightmost_valid;
-    }
+template<typename T>
+void ValidRegion<T>::UpdateRow(int row, int index_leftmost_valid, int index_rightmost_valid) noexcept {
+  // update the global row/column index, the row has at least one valid cell
+  if (row < top || top == -1) {
+    top = row;
+  }
+  if (row > bottom) {
+    bottom = row;
+  }
+  if (index_leftmost_valid < left || left == -1) {
+    left = index_leftmost_valid;
+  }
+  if (index_rightmost_valid > right) {
+    right = index_rightmost_valid;
   }
 }
 
@@ -49,11 +51,6 @@ void ValidRegion<T>::PrintGDALTranslateSrcWin() const {
   }
 }
 
-template<typename T>
-inline bool ValidRegion<T>::ValueIsValid(T value) const noexcept {
-  return value != nodata;
-}
-
 template<typename T>
 bool ValidRegion<T>::RegionIsValid() const noexcept {
   return top > -1 && bottom > -1 && right > -1 && left > -1;
@@ -9,14 +9,14 @@ class ValidRegion : public Region {
  public:
   ValidRegion();
   explicit ValidRegion(T);
-  void UpdateFromLine(T *, int) noexcept;
+  // update from a (partial) block of `x_size` x `y_size` cells located at (x_off, y_off) in the band,
+  // rows of the block buffer are `block_x_size` cells apart
+  void UpdateFromBlock(const T *, int block_x_size, int x_off, int y_off, int x_size, int y_size) noexcept;
   void PrintGDALTranslateSrcWin() const;
 
  private:
   const T nodata;
-  int line_index{};
 
-  [[nodiscard]]
-  inline bool ValueIsValid(T) const noexcept;
   [[nodiscard]] bool RegionIsValid() const noexcept;
+  void UpdateRow(int row, int index_leftmost_valid, int index_rightmost_valid) noexcept;
 };
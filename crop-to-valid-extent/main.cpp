@@ -1,95 +1,133 @@
 #include <iostream>
+#include <filesystem>
+#include <fstream>
 #include <string>
 #include <vector>
 #include <memory>
 #include <gdal_priv.h>
 #include "deps/CLI11.hpp"
-#include "ValidRegion.h"
+#include "Batch.h"
+#include "Crop.h"
+#include "RasterValidRegion.h"
 #include "Region.h"
 
-Region GetBandValidRegion(GDALRasterBand *);
-template<typename T>
-Region GetTypedBandValidRegion(GDALRasterBand *);
-
 int main(int argc, char **argv) {
   CLI::App app
       ("Print the minimum valid extent of raster band(s) which can be used as -srcwin parameter in gdal_translate cmd tool");
 
   std::string input_raster;
-  int band_index{0};
-  bool union_region;
+  std::string batch_input;
+  BatchFormat batch_format{BatchFormat::Json};
+  RasterValidRegionOptions options;
+  std::string output_raster;
+  std::string output_vrt;
+  std::string output_format{"GTiff"};
+  std::vector<std::string> creation_options;
 
-  app.add_option("--raster", input_raster, "")->required()->check(CLI::ExistingFile);
+  auto input_group = app.add_option_group("input");
+  input_group->add_option("--raster", input_raster, "")->check(CLI::ExistingFile);
+  auto batch_option = input_group->add_option("--batch",
+                          batch_input,
+                          "file with one raster path per line, '-' reads from stdin. "
+                          "One result line is printed per raster.");
+  input_group->require_option(1);
+  app.add_option("--format", batch_format, "format of the batch result lines: json or csv.")
+      ->transform(CLI::CheckedTransformer(std::map<std::string, BatchFormat>{{"json", BatchFormat::Json},
+                                                                              {"csv", BatchFormat::Csv}},
+                                          CLI::ignore_case))
+      ->default_str("json")
+      ->needs(batch_option);
   app.add_option("--band",
-                 band_index,
+                 options.band_index,
                  "specific which band will be used to extract the valid extent, zero means all bands.")->default_val(0);
-  app.add_flag("--union", union_region, "Print the union of regions. Default is intersection.")->default_val(false);
+  app.add_flag("--union", options.union_region, "Print the union of regions. Default is intersection.")
+      ->default_val(false);
+  app.add_option("--scan",
+                 options.scan_mode,
+                 "full: read the whole band; edge: search from the edges inward and stop at the first valid cell; "
+                 "overview: locate the region on the smallest overview and only search its boundary at full resolution, "
+                 "overviews whose RESAMPLING metadata is missing or not a nodata aware method (average, mode, ...) "
+                 "fall back to edge.")
+      ->transform(CLI::CheckedTransformer(std::map<std::string, ScanMode>{{"full", ScanMode::Full},
+                                                                           {"edge", ScanMode::Edge},
+                                                                           {"overview", ScanMode::Overview}},
+                                          CLI::ignore_case))
+      ->default_str("full");
+  app.add_flag("--trust-overview",
+               options.trust_overview,
+               "use the overview of --scan overview even if its RESAMPLING metadata is missing or nearest, "
+               "only correct if every overview cell over valid cells is valid.")
+      ->default_val(false);
+  app.add_option("--validity",
+                 options.validity,
+                 "nodata: cells equal to the nodata value are invalid; mask: cells masked out by the mask band "
+                 "(nodata, alpha band or per dataset mask) are invalid, bands without any mask are not read.")
+      ->transform(CLI::CheckedTransformer(std::map<std::string, Validity>{{"nodata", Validity::NoData},
+                                                                           {"mask", Validity::Mask}},
+                                          CLI::ignore_case))
+      ->default_str("nodata");
+  app.add_option("--threads",
+                 options.threads,
+                 "number of worker threads, each of them opens its own dataset handle. "
+                 "In batch mode the rasters are processed concurrently.")
+      ->default_val(1)
+      ->check(CLI::PositiveNumber);
+  app.add_option("--output",
+                 output_raster,
+                 "write the cropped raster to this file instead of printing the srcwin. "
+                 "Georeferencing and nodata values are kept.")
+      ->excludes(batch_option);
+  app.add_option("--vrt",
+                 output_vrt,
+                 "write a VRT of the cropped window referencing the input raster, no pixel is copied.")
+      ->excludes(batch_option)
+      ->excludes("--output");
+  app.add_option("--of", output_format, "GDAL driver of --output.")->default_val("GTiff");
+  app.add_option("--co", creation_options, "creation option of --output, can be repeated.");
   CLI11_PARSE(app, argc, argv);
 
   GDALAllRegister();
 
-  auto in_ds = (GDALDataset *) GDALOpen(input_raster.c_str(), GA_ReadOnly);
-  if (in_ds == nullptr) {
-    std::cerr << "Failed to open file: " << input_raster << std::endl;
-    exit(EXIT_FAILURE);
-  }
-
-  int band_number = in_ds->GetRasterCount();
-  if (band_number == 0 || band_index < 0 || band_index > band_number) {
-    std::cerr << "Invalid Band: " << band_index << std::endl;
-    exit(EXIT_FAILURE);
+  if (!batch_input.empty()) {
+    int failures;
+    if (batch_input == "-") {
+      failures = RunBatch(std::cin, std::cout, options, batch_format);
+    } else {
+      std::ifstream batch_file{batch_input};
+      if (!batch_file) {
+        std::cerr << "Failed to open file: " << batch_input << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      failures = RunBatch(batch_file, std::cout, options, batch_format);
+    }
+    return failures == 0 ? 0 : EXIT_FAILURE;
   }
 
-  if (band_index != 0) {
-    auto band = in_ds->GetRasterBand(band_index);
-    auto band_valid_region = GetBandValidRegion(band);
-    band_valid_region.PrintGDALTranslateSrcWin();
-  } else {
-    std::vector<Region> regions;
-    for (int i = 1; i <= band_number; ++i) {
-      auto band = in_ds->GetRasterBand(i);
-      auto band_valid_region = GetBandValidRegion(band);
-      regions.push_back(band_valid_region);
+  try {
+    if (!output_vrt.empty() || !output_raster.empty()) {
+      // both outputs go through a VRT referencing the input raster, --vrt may be written to another directory
+      // than the current one
+      input_raster = std::filesystem::absolute(input_raster).string();
     }
-    Region region;
-    if (union_region) {
-      region = UnionRegions(regions);
+    // --output copies the pixels from the same dataset handle, the full scan then reads through the block cache
+    // so that the copy reuses the blocks still cached instead of reading them from disk a second time.
+    // Only the blocks scanned by the first worker (the given handle) are shared.
+    options.cache_blocks = !output_raster.empty();
+    auto dataset = OpenRaster(input_raster);
+    auto result = GetRasterValidRegion(dataset.get(), options);
+    if (!output_vrt.empty()) {
+      WriteCroppedVRT(dataset.get(), result.region, output_vrt);
+    } else if (output_raster.empty()) {
+      result.region.PrintGDALTranslateSrcWin();
     } else {
-      region = IntersectRegions(regions);
+      // written from the same dataset handle, so blocks still cached from the scan (edge, overview, or full with
+      // cache_blocks) are reused
+      WriteCroppedRaster(dataset.get(), result.region, output_raster, output_format, creation_options);
     }
-    region.PrintGDALTranslateSrcWin();
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    exit(EXIT_FAILURE);
   }
 
   return 0;
 }
-
-Region GetBandValidRegion(GDALRasterBand *band) {
-  GDALDataType data_type = band->GetRasterDataType();
-  switch (data_type) {
-    case GDT_Byte:return GetTypedBandValidRegion<char>(band);
-    case GDT_Int16:return GetTypedBandValidRegion<int16_t>(band);
-    case GDT_UInt16:return GetTypedBandValidRegion<uint16_t>(band);
-    case GDT_Int32:return GetTypedBandValidRegion<int32_t>(band);
-    case GDT_UInt32:return GetTypedBandValidRegion<uint32_t>(band);
-    case GDT_Float32:return GetTypedBandValidRegion<float_t>(band);
-    case GDT_Float64:return GetTypedBandValidRegion<double_t>(band);
-    default: return {-1, -1, -1, -1};
-  }
-};
-
-template<typename T>
-Region GetTypedBandValidRegion(GDALRasterBand *band) {
-  int cols = band->GetXSize(), rows = band->GetYSize();
-  std::unique_ptr<T[]> line_data{new T[cols]};
-  ValidRegion<T> region(static_cast<T>(band->GetNoDataValue()));
-
-  for (int row = 0; row != rows; ++row) {
-    auto err = band->RasterIO(GF_Read, 0, row, cols, 1, line_data.get(), cols, 1, band->GetRasterDataType(), 0, 0);
-    if (err != CE_None) {
-      throw std::runtime_error("Raster IO Error!");
-    }
-    region.UpdateFromLine(line_data.get(), cols);
-  }
-
-  return region;
-}
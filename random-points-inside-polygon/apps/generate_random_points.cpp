@@ -1,48 +1,226 @@
 #include <iostream>
 #include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <vector>
 
 #include <gdal.h>
 #include <ogrsf_frmts.h>
 
+#include "CLI11.hpp"
 #include "../source/roi.h"
+#include "../source/point_writer.h"
+#include "../source/parallel_generator.h"
+#include "../source/low_discrepancy.h"
+
+namespace {
+
+/**
+ * 将分别保存的x、y坐标分批转换为交错数组写入
+ */
+void WritePoints(PointWriter &writer, const std::vector<double> &x, const std::vector<double> &y) {
+  constexpr size_t kBatchSize = 1 << 16;
+  std::vector<double> points_xy(kBatchSize * 2);
+  for (size_t offset = 0; offset < x.size(); offset += kBatchSize) {
+    size_t batch = std::min(kBatchSize, x.size() - offset);
+    for (size_t i = 0; i != batch; ++i) {
+      points_xy[i * 2] = x[offset + i];
+      points_xy[i * 2 + 1] = y[offset + i];
+    }
+    writer.Write(points_xy.data(), batch);
+  }
+}
+
+/**
+ * 按要素生成随机点，连同所属要素的FID分批写入
+ */
+template<typename URNG>
+void WriteFeaturePoints(const ROI &roi, const std::vector<size_t> &counts, URNG &engine, PointWriter &writer) {
+  constexpr size_t kBatchSize = 1 << 16;
+  std::vector<double> points_xy;
+  std::vector<int64_t> source_fids;
+  points_xy.reserve(kBatchSize * 2);
+  source_fids.reserve(kBatchSize);
+  const auto &feature_fids = roi.FeatureFids();
+  roi.GenFeaturePoints(engine, counts, [&](size_t feature_index, size_t count, const double *x, const double *y) {
+    for (size_t i = 0; i != count; ++i) {
+      points_xy.push_back(x[i]);
+      points_xy.push_back(y[i]);
+    }
+    source_fids.insert(source_fids.cend(), count, feature_fids[feature_index]);
+    if (source_fids.size() >= kBatchSize) {
+      writer.Write(points_xy.data(), source_fids.data(), source_fids.size());
+      points_xy.clear();
+      source_fids.clear();
+    }
+  });
+  writer.Write(points_xy.data(), source_fids.data(), source_fids.size());
+}
+
+/**
+ * 计算每个要素的点数量
+ */
+template<typename URNG>
+std::vector<size_t> FeaturePointCounts(const ROI &roi, const std::string &allocation, size_t n, URNG &engine) {
+  if (allocation == "feature") {
+    return std::vector<size_t>(roi.FeaturesNum(), n);
+  }
+  if (allocation == "field") {
+    std::vector<size_t> counts;
+    counts.reserve(roi.FeaturesNum());
+    for (auto value: roi.FeatureValues()) {
+      if (!(value >= 0) || std::isinf(value)) {
+        throw std::runtime_error("点数量字段的值必须为非负数");
+      }
+      counts.push_back(static_cast<size_t>(std::llround(value)));
+    }
+    return counts;
+  }
+  double offset;
+  FillUniform(engine, &offset, 1);
+  return AllocatePointsByWeight(n, roi.FeatureValues(), offset);
+}
+
+}
 
 int main(int argc, char **argv) {
-  GDALAllRegister();
+  CLI::App app("在多边形内生成随机点");
 
-  const char *polygon_path = argv[1];
-  const char *output_random_points = argv[2];
-  const int random_points_num = atoi(argv[3]);
+  std::string polygon_path;
+  std::string output_random_points;
+  size_t random_points_num{};
+  std::string output_format{"gpkg"};
+  ROIOptions roi_options;
+  PointWriterOptions writer_options;
+  std::string sampling{"uniform"};
+  std::string allocation{"area"};
+  std::string engine{"mt19937_64"};
+  double min_distance{};
+  bool scramble{false};
+  ParallelGenerateOptions generate_options;
 
-  ROI roi(polygon_path);
+  app.add_option("polygon", polygon_path, "多边形矢量文件")->required();
+  app.add_option("output", output_random_points, "输出文件")->required();
+  auto number_option = app.add_option("number", random_points_num, "随机点数量，--allocation feature时为每个要素的点数量");
+  app.add_option("--format", output_format, "输出格式：gpkg、flatgeobuf、csv、geojsonseq、binary")
+      ->check(CLI::IsMember({"gpkg", "flatgeobuf", "csv", "geojsonseq", "binary"}))
+      ->default_val("gpkg");
+  app.add_option("--curve-step", roi_options.curve_step_degrees, "曲线多边形线性化时每段圆弧的最大角度，0表示使用GDAL默认值")
+      ->check(CLI::NonNegativeNumber)
+      ->default_val(0);
+  app.add_flag("--equal-area", roi_options.equal_area, "按椭球面上的真实面积均匀生成随机点，适用于经纬度坐标的多边形");
+  app.add_option("--cache-dir", roi_options.cache_dir, "三角剖分结果缓存目录，多边形文件未修改时直接使用缓存");
+  app.add_option("--transaction-size",
+                 writer_options.transaction_size,
+                 "gpkg、flatgeobuf：每个事务写入的点数量，0表示每个点单独提交")
+      ->default_val(100000);
+  app.add_flag("--defer-spatial-index",
+               writer_options.defer_spatial_index,
+               "gpkg：写入完成后再一次性建立空间索引");
+  app.add_option("--threads", generate_options.threads, "三角剖分及生成随机点的线程数量")
+      ->check(CLI::PositiveNumber)
+      ->default_val(1);
+  app.add_option("--sampling",
+                 sampling,
+                 "抽样方式：uniform(独立均匀)、stratified(按三角形面积分层)、grid(网格抖动)、poisson(泊松圆盘)、"
+                 "sobol、halton(低差异准随机序列)")
+      ->check(CLI::IsMember({"uniform", "stratified", "grid", "poisson", "sobol", "halton"}))
+      ->default_val("uniform");
+  auto min_distance_option = app.add_option("--min-distance", min_distance, "poisson：任意两点间的最小距离")
+      ->check(CLI::PositiveNumber);
+  app.add_flag("--scramble", scramble, "sobol、halton：使用随机数种子进行Owen置乱，不指定时序列固定");
+  app.add_option("--allocation",
+                 allocation,
+                 "点数量分配方式：area(按面积)、feature(每个要素number个点)、field(每个要素的点数量取--field字段值)、"
+                 "weight(number个点按--field字段值分配给各要素)")
+      ->check(CLI::IsMember({"area", "feature", "field", "weight"}))
+      ->default_val("area");
+  app.add_option("--field", roi_options.attribute_field, "field、weight：点数量或权重字段");
+  app.add_option("--engine",
+                 engine,
+                 "uniform抽样及按要素分配时的随机数引擎：mt19937_64、xoshiro256pp、pcg64、batched(批量生成)、"
+                 "philox(计数器引擎，第i个点只与种子及i有关)")
+      ->check(CLI::IsMember({"mt19937_64", "xoshiro256pp", "pcg64", "batched", "philox"}))
+      ->default_val("mt19937_64");
+  auto offset_option = app.add_option("--offset",
+                                      generate_options.first_index,
+                                      "philox：第一个点的序号，用于单独重新生成或接续生成某一范围的点")
+      ->default_val(0);
+  auto seed_option = app.add_option("--seed", generate_options.seed, "随机数种子，不指定时随机选取");
+  CLI11_PARSE(app, argc, argv);
 
-  auto driver = GetGDALDriverManager()->GetDriverByName("GPKG");
-  GDALDriver::QuietDelete(output_random_points);
-  auto dataset = driver->Create(output_random_points, 0, 0, 0, GDT_Unknown, nullptr);
-  if (dataset == nullptr) {
-    std::cout << "创建数据集失败" << std::endl;
+  if (allocation != "field" && number_option->count() == 0) {
+    std::cout << "需要指定随机点数量" << std::endl;
     return 1;
   }
-
-  auto layer = dataset->CreateLayer("points", nullptr, wkbPoint, nullptr);
-  if (layer == nullptr) {
-    std::cout << "创建图层失败" << std::endl;
+  if ((allocation == "field" || allocation == "weight") && roi_options.attribute_field.empty()) {
+    std::cout << allocation << "分配方式需要指定--field" << std::endl;
+    return 1;
+  }
+  if (allocation != "area" && sampling != "uniform") {
+    std::cout << "按要素分配点数量时只支持uniform抽样" << std::endl;
+    return 1;
+  }
+  if (offset_option->count() != 0 && (engine != "philox" || sampling != "uniform" || allocation != "area")) {
+    std::cout << "--offset只能用于philox引擎的uniform抽样" << std::endl;
+    return 1;
+  }
+  if (sampling == "poisson" && min_distance_option->count() == 0) {
+    std::cout << "poisson抽样需要指定--min-distance" << std::endl;
     return 1;
   }
+  if (seed_option->count() == 0) {
+    std::random_device random_device;
+    generate_options.seed = (static_cast<uint64_t>(random_device()) << 32) | random_device();
+  }
+
+  generate_options.engine = ParseRandomEngineType(engine);
 
-  for (int i = 0; i != random_points_num; ++i) {
-    OGRFeature feat{layer->GetLayerDefn()};
+  GDALAllRegister();
 
-    auto point_xy = roi.GenRandomPoint();
-    OGRPoint pt{point_xy[0], point_xy[1]};
-    feat.SetGeometry(&pt);
-    auto err = layer->CreateFeature(&feat);
-    if (err != CE_None) {
-      std::cout << "创建要素失败" << std::endl;
-      return 1;
+  try {
+    roi_options.threads = generate_options.threads;
+    if (allocation == "area") {
+      roi_options.attribute_field.clear();
     }
-  }
+    writer_options.source_fid = allocation != "area";
+    ROI roi(polygon_path, roi_options);
+    auto writer = CreatePointWriter(output_format, output_random_points, writer_options);
 
-  GDALClose(dataset);
+    if (allocation != "area") {
+      // 各要素的点连续生成，点数量与线程数量无关
+      std::seed_seq seed_seq{static_cast<uint32_t>(generate_options.seed),
+                             static_cast<uint32_t>(generate_options.seed >> 32)};
+      WithRandomEngine(generate_options.engine, seed_seq, [&](auto &engine) {
+        auto counts = FeaturePointCounts(roi, allocation, random_points_num, engine);
+        WriteFeaturePoints(roi, counts, engine, *writer);
+      });
+    } else if (sampling == "uniform") {
+      GenerateRandomPointsParallel(roi, random_points_num, *writer, generate_options);
+    } else {
+      // 空间均衡抽样需要一次生成全部点
+      std::vector<double> x, y;
+      if (sampling == "stratified") {
+        roi.GenStratifiedPoints(random_points_num, generate_options.seed, x, y);
+      } else if (sampling == "grid") {
+        roi.GenJitteredGridPoints(random_points_num, generate_options.seed, x, y);
+      } else if (sampling == "sobol" || sampling == "halton") {
+        auto sequence = CreateLowDiscrepancySequence(sampling, scramble, generate_options.seed);
+        roi.GenLowDiscrepancyPoints(*sequence, random_points_num, x, y);
+      } else {
+        roi.GenPoissonDiskPoints(random_points_num, min_distance, generate_options.seed, x, y);
+        if (x.size() < random_points_num) {
+          std::cout << "最小距离过大，只生成了" << x.size() << "个点" << std::endl;
+        }
+      }
+      WritePoints(*writer, x, y);
+    }
+    writer->Close();
+  } catch (const std::exception &e) {
+    std::cout << e.what() << std::endl;
+    return 1;
+  }
 
   return 0;
 }
@@ -0,0 +1,90 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gdal.h>
+
+#include "../source/low_discrepancy.h"
+#include "../source/roi.h"
+#include "benchmark_polygons.h"
+
+namespace {
+
+/**
+ * 被积函数
+ */
+double Integrand(double x, double y) {
+  return x * x + y * y;
+}
+
+/**
+ * 简单多边形上Integrand的精确平均值：由格林公式，面积及x^2、y^2的积分均可由各边的顶点坐标直接求和得到
+ */
+double ExactMean(const ROI::Ring &ring) {
+  double area = 0, xx = 0, yy = 0;
+  for (size_t i = 0; i + 1 < ring.size(); ++i) {
+    double x0 = ring[i][0], y0 = ring[i][1], x1 = ring[i + 1][0], y1 = ring[i + 1][1];
+    double cross = x0 * y1 - x1 * y0;
+    area += cross / 2;
+    xx += cross * (x0 * x0 + x0 * x1 + x1 * x1) / 12;
+    yy += cross * (y0 * y0 + y0 * y1 + y1 * y1) / 12;
+  }
+  return (xx + yy) / area;
+}
+
+double SampleMean(const std::vector<double> &x, const std::vector<double> &y) {
+  double sum = 0;
+  for (size_t i = 0; i != x.size(); ++i) {
+    sum += Integrand(x[i], y[i]);
+  }
+  return sum / static_cast<double>(x.size());
+}
+
+}
+
+/**
+ * 多边形上数值积分(求x^2 + y^2的平均值)的误差随点数量的变化：
+ * std::mt19937独立随机点与Sobol、Halton序列(不置乱及Owen置乱)，
+ * 随机点及置乱序列取不同种子重复repeat次的均方根误差，不置乱序列为确定的单次误差
+ * 用法：benchmark_low_discrepancy [repeat] [最大点数量]
+ */
+int main(int argc, char **argv) {
+  int repeat = argc > 1 ? std::atoi(argv[1]) : 8;
+  size_t max_n = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : size_t{1} << 18;
+  GDALAllRegister();
+
+  auto ring = StarRing(0.3, -0.2, 1.0, 1000);
+  auto roi_path = TemporaryPath("benchmark_low_discrepancy.geojson");
+  WriteGeoJsonPolygons(roi_path, {ring});
+  ROI roi(roi_path);
+  double exact = ExactMean(ring);
+
+  std::printf("%10s %12s %12s %12s %12s %12s\n", "n", "mt19937", "sobol", "sobol_owen", "halton", "halton_owen");
+  std::vector<double> x, y;
+  for (size_t n = size_t{1} << 8; n <= max_n; n <<= 2) {
+    double random_error = 0, sobol_owen_error = 0, halton_owen_error = 0;
+    for (int r = 0; r != repeat; ++r) {
+      std::mt19937 engine(r + 1);
+      x.resize(n);
+      y.resize(n);
+      roi.GenRandomPoints(engine, n, x.data(), y.data());
+      random_error += std::pow(SampleMean(x, y) - exact, 2);
+      roi.GenLowDiscrepancyPoints(SobolSequence{true, static_cast<uint64_t>(r + 1)}, n, x, y);
+      sobol_owen_error += std::pow(SampleMean(x, y) - exact, 2);
+      roi.GenLowDiscrepancyPoints(HaltonSequence{true, static_cast<uint64_t>(r + 1)}, n, x, y);
+      halton_owen_error += std::pow(SampleMean(x, y) - exact, 2);
+    }
+    roi.GenLowDiscrepancyPoints(SobolSequence{}, n, x, y);
+    double sobol_error = std::abs(SampleMean(x, y) - exact);
+    roi.GenLowDiscrepancyPoints(HaltonSequence{}, n, x, y);
+    double halton_error = std::abs(SampleMean(x, y) - exact);
+    std::printf("%10zu %12.3e %12.3e %12.3e %12.3e %12.3e\n", n,
+                std::sqrt(random_error / repeat), sobol_error, std::sqrt(sobol_owen_error / repeat),
+                halton_error, std::sqrt(halton_owen_error / repeat));
+  }
+  std::remove(roi_path.c_str());
+  return 0;
+}
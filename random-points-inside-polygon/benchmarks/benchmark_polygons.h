@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../source/roi.h"
+
+/**
+ * 以(cx, cy)为中心、半径在r * (1 ± 0.3)之间起伏的7瓣星形多边形外环，首尾顶点相同
+ */
+inline ROI::Ring StarRing(double cx, double cy, double r, int vertices) {
+  ROI::Ring ring;
+  for (int i = 0; i <= vertices; ++i) {
+    double angle = 2 * M_PI * (i % vertices) / vertices;
+    double radius = r * (1 + 0.3 * std::sin(7 * angle));
+    ring.push_back({cx + radius * std::cos(angle), cy + radius * std::sin(angle)});
+  }
+  return ring;
+}
+
+/**
+ * 将多个多边形外环写入GeoJSON文件，坐标使用17位有效数字，读回后与写入的值相同
+ */
+inline void WriteGeoJsonPolygons(const std::string &path, const std::vector<ROI::Ring> &rings) {
+  std::FILE *file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    throw std::runtime_error("无法创建文件：" + path);
+  }
+  std::fprintf(file, "{\"type\":\"FeatureCollection\",\"features\":[");
+  for (size_t i = 0; i != rings.size(); ++i) {
+    std::fprintf(file, "%s\n{\"type\":\"Feature\",\"properties\":{},\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[",
+                 i == 0 ? "" : ",");
+    for (size_t j = 0; j != rings[i].size(); ++j) {
+      std::fprintf(file, "%s[%.17g,%.17g]", j == 0 ? "" : ",", rings[i][j][0], rings[i][j][1]);
+    }
+    std::fprintf(file, "]]}}");
+  }
+  std::fprintf(file, "\n]}\n");
+  std::fclose(file);
+}
+
+/**
+ * 临时目录下的文件路径
+ */
+inline std::string TemporaryPath(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../source/random_engines.h"
+
+namespace {
+
+constexpr const char *kEngineNames[] = {"mt19937_64", "xoshiro256pp", "pcg64", "batched", "philox"};
+
+/**
+ * 执行function(repeat)并返回每次调用的平均耗时(秒)，先执行一次预热
+ */
+template<typename Function>
+double Measure(int repeat, Function &&function) {
+  function();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i != repeat; ++i) {
+    function();
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repeat;
+}
+
+void PrintRow(const char *name, double raw_seconds, double uniform_seconds, size_t n) {
+  std::printf("%-28s %14.1f %14.1f %10.2f\n", name, n / raw_seconds * 1e-6, n / uniform_seconds * 1e-6,
+              uniform_seconds / n * 1e9);
+}
+
+}
+
+/**
+ * 各随机数引擎的吞吐量：逐个生成原始随机数，以及FillUniform生成[0, 1)区间double(每个点使用3个)
+ * 用法：benchmark_random_engines [每轮随机数数量]
+ */
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t{1} << 22;
+  constexpr int kRepeat = 10;
+  std::vector<double> values(n);
+  uint64_t checksum = 0;
+
+  std::printf("%-28s %14s %14s %10s\n", "engine", "raw M/s", "uniform M/s", "ns/double");
+
+  // 重构前的方式：std::mt19937配合std::uniform_real_distribution逐个生成
+  {
+    std::mt19937 engine{20240601};
+    std::uniform_real_distribution<double> rand_zero_one{0.0, 1.0};
+    double raw = Measure(kRepeat, [&]() {
+      for (size_t i = 0; i != n; ++i) {
+        checksum += engine();
+      }
+    });
+    double uniform = Measure(kRepeat, [&]() {
+      for (size_t i = 0; i != n; ++i) {
+        values[i] = rand_zero_one(engine);
+      }
+    });
+    PrintRow("mt19937+uniform_real_dist", raw, uniform, n);
+  }
+
+  for (int type = 0; type != static_cast<int>(std::size(kEngineNames)); ++type) {
+    std::seed_seq seed_seq{20240601};
+    WithRandomEngine(static_cast<RandomEngineType>(type), seed_seq, [&](auto &engine) {
+      double raw = Measure(kRepeat, [&]() {
+        for (size_t i = 0; i != n; ++i) {
+          checksum += engine();
+        }
+      });
+      double uniform = Measure(kRepeat, [&]() { FillUniform(engine, values.data(), n); });
+      PrintRow(kEngineNames[type], raw, uniform, n);
+    });
+  }
+
+  // 防止生成随机数的循环被优化掉
+  std::printf("(checksum %llx %g)\n", static_cast<unsigned long long>(checksum), values[n / 2]);
+  return 0;
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gdal.h>
+
+#include "mapbox/earcut.hpp"
+#include "../source/roi.h"
+#include "benchmark_polygons.h"
+
+namespace {
+
+/**
+ * 重构前的抽样方式：每个多边形分别保存顶点数组、earcut顶点索引及三角形面积累加值，
+ * 每个点先按面积二分查找多边形，再在多边形内二分查找三角形，并复制该多边形的整个顶点索引数组
+ */
+class LegacySampler {
+ public:
+  explicit LegacySampler(const std::vector<ROI::Ring> &rings) {
+    for (const auto &ring: rings) {
+      ROI::Rings polygon{ring};
+      polygon_vertices_.push_back(ring);
+      polygon_triangulations_.push_back(mapbox::earcut<ROI::Triangulation_N>(polygon));
+      const auto &indices = polygon_triangulations_.back();
+      std::vector<double> area_acc;
+      for (size_t j = 0; j + 2 < indices.size(); j += 3) {
+        const auto &p1 = ring[indices[j]], &p2 = ring[indices[j + 1]], &p3 = ring[indices[j + 2]];
+        double area = CalculateTriangleArea(p1[0], p1[1], p2[0], p2[1], p3[0], p3[1]);
+        area_acc.push_back(area + (area_acc.empty() ? 0 : area_acc.back()));
+      }
+      polygon_area_acc_.push_back(area_acc.back() + (polygon_area_acc_.empty() ? 0 : polygon_area_acc_.back()));
+      triangle_area_acc_.push_back(std::move(area_acc));
+    }
+  }
+
+  [[nodiscard]] size_t TrianglesNum() const {
+    size_t triangles_num = 0;
+    for (const auto &indices: polygon_triangulations_) {
+      triangles_num += indices.size() / 3;
+    }
+    return triangles_num;
+  }
+
+  std::array<double, 2> GenRandomPoint(std::mt19937 &engine) {
+    double target_polygon_area = rand_zero_one_(engine) * polygon_area_acc_.back();
+    size_t polygon_index = FindIndex(polygon_area_acc_, target_polygon_area);
+    double target_triangle_area = rand_zero_one_(engine) * triangle_area_acc_[polygon_index].back();
+    size_t triangle_index = FindIndex(triangle_area_acc_[polygon_index], target_triangle_area);
+    // 重构前的写法，每个点复制一次多边形的全部顶点索引
+    auto polygon_triangulation = polygon_triangulations_[polygon_index];
+    double u = rand_zero_one_(engine), v = rand_zero_one_(engine);
+    const auto &vertices = polygon_vertices_[polygon_index];
+    const auto &p1 = vertices[polygon_triangulation[triangle_index * 3]];
+    const auto &p2 = vertices[polygon_triangulation[triangle_index * 3 + 1]];
+    const auto &p3 = vertices[polygon_triangulation[triangle_index * 3 + 2]];
+    if (u + v > 1) {
+      u = 1 - u;
+      v = 1 - v;
+    }
+    return {u * (p3[0] - p1[0]) + v * (p2[0] - p1[0]) + p1[0],
+            u * (p3[1] - p1[1]) + v * (p2[1] - p1[1]) + p1[1]};
+  }
+
+ private:
+  std::vector<ROI::Ring> polygon_vertices_;
+  std::vector<std::vector<ROI::Triangulation_N>> polygon_triangulations_;
+  std::vector<std::vector<double>> triangle_area_acc_;
+  std::vector<double> polygon_area_acc_;
+  std::uniform_real_distribution<double> rand_zero_one_{0.0, 1.0};
+
+  static size_t FindIndex(const std::vector<double> &acc, double target) {
+    auto index = static_cast<size_t>(std::upper_bound(acc.begin(), acc.end(), target) - acc.begin());
+    return std::min(index, acc.size() - 1);
+  }
+};
+
+/**
+ * 生成n个点，返回每个点的平均耗时(纳秒)
+ */
+template<typename Function>
+double NanosecondsPerPoint(size_t n, Function &&gen_point) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i != n; ++i) {
+    gen_point();
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+}
+
+void RunCase(int polygons, int vertices, size_t n) {
+  std::vector<ROI::Ring> rings;
+  for (int i = 0; i != polygons; ++i) {
+    rings.push_back(StarRing(i * 10.0, 0, 4, vertices));
+  }
+  auto roi_path = TemporaryPath("benchmark_roi_sampling.geojson");
+  WriteGeoJsonPolygons(roi_path, rings);
+  ROI roi(roi_path);
+  std::remove(roi_path.c_str());
+  LegacySampler legacy{rings};
+
+  double checksum = 0;
+  std::mt19937 legacy_engine{1};
+  // 重构前的方式每个点的耗时与多边形三角形数量成正比，生成的点较少
+  double legacy_ns = NanosecondsPerPoint(std::max<size_t>(1000, n / 1000), [&]() {
+    checksum += legacy.GenRandomPoint(legacy_engine)[0];
+  });
+  std::mt19937 engine{1};
+  double single_ns = NanosecondsPerPoint(n, [&]() { checksum += roi.GenRandomPoint(engine)[0]; });
+  std::vector<double> xy(2 * n);
+  auto start = std::chrono::steady_clock::now();
+  roi.GenRandomPoints(engine, n, xy.data());
+  double batch_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+  checksum += xy[n];
+
+  std::printf("%9d %9d %10zu %12.1f %12.1f %12.1f %9.1fx  (%g)\n", polygons, vertices, legacy.TrianglesNum(),
+              legacy_ns, single_ns, batch_ns, legacy_ns / single_ns, checksum);
+}
+
+}
+
+/**
+ * 每个点的平均耗时：重构前按多边形保存三角剖分索引并在每个点复制索引数组的方式，
+ * 与扁平化三角形表(顶点坐标直接保存在三角形中)加别名表选择三角形的方式，均使用std::mt19937
+ * 用法：benchmark_roi_sampling [点数量]
+ */
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+  GDALAllRegister();
+
+  std::printf("%9s %9s %10s %12s %12s %12s %10s\n",
+              "polygons", "vertices", "triangles", "legacy ns", "single ns", "batch ns", "speedup");
+  RunCase(1, 1000, n);
+  RunCase(50, 2000, n);
+  RunCase(20, 25000, n);
+  return 0;
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gdal.h>
+
+#include "mapbox/earcut.hpp"
+#include "../source/roi.h"
+#include "../source/splitmix.h"
+#include "benchmark_polygons.h"
+
+namespace {
+
+/**
+ * 沿对角线方向、长length宽width的狭长矩形，每条长边上均匀分布vertices个顶点，
+ * earcut剖分得到的三角形均为外包矩形远大于自身面积的狭长三角形
+ */
+ROI::Ring DiagonalStrip(double length, double width, int vertices) {
+  double ux = std::sqrt(0.5), uy = std::sqrt(0.5);
+  double nx = -uy * width, ny = ux * width;
+  ROI::Ring ring;
+  for (int i = 0; i <= vertices; ++i) {
+    double t = length * i / vertices;
+    ring.push_back({t * ux, t * uy});
+  }
+  for (int i = vertices; i >= 0; --i) {
+    double t = length * i / vertices;
+    ring.push_back({t * ux + nx, t * uy + ny});
+  }
+  ring.push_back(ring.front());
+  return ring;
+}
+
+double Cross(const ROI::Point &a, const ROI::Point &b, const ROI::Point &c) {
+  return (b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]);
+}
+
+/**
+ * 修改前的网格抖动抽样：遍历每个三角形外包矩形内的全部网格，网格随机点与ROI::GenJitteredGridPoints相同
+ */
+void BoundingBoxJitteredGrid(const std::vector<ROI::Ring> &rings, size_t n, uint64_t seed,
+                             std::vector<std::pair<double, double>> &points) {
+  std::vector<ROI::Triangle> triangles;
+  for (const auto &ring: rings) {
+    ROI::Rings polygon{ring};
+    auto indices = mapbox::earcut<ROI::Triangulation_N>(polygon);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+      triangles.push_back({ring[indices[i]], ring[indices[i + 1]], ring[indices[i + 2]]});
+    }
+  }
+  std::vector<double> areas(triangles.size());
+  CalculateTriangleAreas(triangles.data(), triangles.size(), areas.data());
+  double total_area = 0;
+  for (double area: areas) {
+    total_area += area;
+  }
+  double cell_size = std::sqrt(total_area / static_cast<double>(n));
+  points.clear();
+  for (size_t t = 0; t != triangles.size(); ++t) {
+    if (!(areas[t] > 0)) {
+      continue;
+    }
+    const auto &triangle = triangles[t];
+    auto column_begin = static_cast<int64_t>(std::floor(std::min({triangle.p1[0], triangle.p2[0], triangle.p3[0]}) / cell_size));
+    auto column_end = static_cast<int64_t>(std::floor(std::max({triangle.p1[0], triangle.p2[0], triangle.p3[0]}) / cell_size));
+    auto row_begin = static_cast<int64_t>(std::floor(std::min({triangle.p1[1], triangle.p2[1], triangle.p3[1]}) / cell_size));
+    auto row_end = static_cast<int64_t>(std::floor(std::max({triangle.p1[1], triangle.p2[1], triangle.p3[1]}) / cell_size));
+    for (int64_t row = row_begin; row <= row_end; ++row) {
+      for (int64_t column = column_begin; column <= column_end; ++column) {
+        uint64_t hash = SplitMix64(seed ^ SplitMix64(static_cast<uint64_t>(column) ^ SplitMix64(static_cast<uint64_t>(row))));
+        ROI::Point point{(static_cast<double>(column) + ToUnitDouble(hash)) * cell_size,
+                         (static_cast<double>(row) + ToUnitDouble(SplitMix64(hash))) * cell_size};
+        double d1 = Cross(triangle.p1, triangle.p2, point);
+        double d2 = Cross(triangle.p2, triangle.p3, point);
+        double d3 = Cross(triangle.p3, triangle.p1, point);
+        if (!((d1 < 0 || d2 < 0 || d3 < 0) && (d1 > 0 || d2 > 0 || d3 > 0))) {
+          points.emplace_back(point[0], point[1]);
+        }
+      }
+    }
+  }
+}
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RunCase(const char *name, const std::vector<ROI::Ring> &rings, size_t n) {
+  auto roi_path = TemporaryPath("benchmark_spatial_sampling.geojson");
+  WriteGeoJsonPolygons(roi_path, rings);
+  ROI roi(roi_path);
+  std::remove(roi_path.c_str());
+
+  std::vector<double> x, y;
+  auto start = std::chrono::steady_clock::now();
+  roi.GenJitteredGridPoints(n, 1, x, y);
+  double row_seconds = Seconds(start);
+
+  std::vector<std::pair<double, double>> reference;
+  start = std::chrono::steady_clock::now();
+  BoundingBoxJitteredGrid(rings, n, 1, reference);
+  double bbox_seconds = Seconds(start);
+
+  std::vector<std::pair<double, double>> points;
+  for (size_t i = 0; i != x.size(); ++i) {
+    points.emplace_back(x[i], y[i]);
+  }
+  std::sort(points.begin(), points.end());
+  std::sort(reference.begin(), reference.end());
+  std::printf("%-24s %10zu %12.3f %12.3f %9.1fx %6s\n", name, points.size(), bbox_seconds, row_seconds,
+              bbox_seconds / row_seconds, points == reference ? "yes" : "no");
+}
+
+}
+
+/**
+ * 网格抖动抽样的耗时：修改前遍历三角形外包矩形内的全部网格，与逐行遍历三角形覆盖的网格，
+ * 狭长三角形较多时外包矩形的面积远大于三角形面积，结果两者应生成相同的点
+ * 用法：benchmark_spatial_sampling [点数量]
+ */
+int main(int argc, char **argv) {
+  size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+  GDALAllRegister();
+
+  std::printf("%-24s %10s %12s %12s %10s %6s\n", "polygon", "points", "bbox s", "row s", "speedup", "same");
+  std::vector<ROI::Ring> stars;
+  for (int i = 0; i != 20; ++i) {
+    stars.push_back(StarRing(i * 10.0, 0, 4, 2000));
+  }
+  RunCase("20 stars", stars, n);
+  RunCase("diagonal strip 1:100", {DiagonalStrip(100, 1, 50)}, n);
+  RunCase("diagonal strip 1:1000", {DiagonalStrip(1000, 1, 2)}, n);
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include <numeric>
+#include <stdexcept>
+
+#include "alias_table.h"
+
+AliasTable::AliasTable(const std::vector<double> &weights) {
+  double total = std::accumulate(weights.cbegin(), weights.cend(), 0.0);
+  if (weights.empty() || !(total > 0)) {
+    throw std::invalid_argument("别名表权重总和必须大于0");
+  }
+
+  // Vose算法：按平均权重缩放后分为小于1和不小于1两组，每次用一个大项补齐一个小项
+  auto n = weights.size();
+  storage_.resize(n);
+  std::vector<double> scaled(n);
+  std::vector<size_t> small, large;
+  for (size_t i = 0; i != n; ++i) {
+    scaled[i] = weights[i] * static_cast<double>(n) / total;
+    (scaled[i] < 1 ? small : large).push_back(i);
+  }
+
+  while (!small.empty() && !large.empty()) {
+    size_t less = small.back();
+    small.pop_back();
+    size_t more = large.back();
+
+    storage_[less] = Entry{scaled[less], more};
+    scaled[more] -= 1 - scaled[less];
+    if (scaled[more] < 1) {
+      large.pop_back();
+      small.push_back(more);
+    }
+  }
+  // 剩余项的概率理论上为1，舍入误差忽略不计
+  for (auto i: large) {
+    storage_[i] = Entry{1, i};
+  }
+  for (auto i: small) {
+    storage_[i] = Entry{1, i};
+  }
+  entries_ = storage_.data();
+  size_ = n;
+}
+
+AliasTable AliasTable::View(const Entry *entries, size_t size) {
+  AliasTable table;
+  table.entries_ = entries;
+  table.size_ = size;
+  return table;
+}
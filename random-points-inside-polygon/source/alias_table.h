@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Walker/Vose别名表，按权重在O(1)时间内随机选择索引
+ */
+class AliasTable {
+ public:
+  struct Entry {
+    // 选择表项本身的概率
+    double probability;
+    // 未选择表项本身时使用的索引
+    size_t alias;
+  };
+
+  AliasTable() = default;
+
+  /**
+   * 依据权重(非负，总和大于0)建立别名表
+   */
+  explicit AliasTable(const std::vector<double> &weights);
+
+  // entries_可能指向自身的storage_，复制后会指向原对象的数据
+  AliasTable(const AliasTable &) = delete;
+  AliasTable &operator=(const AliasTable &) = delete;
+  AliasTable(AliasTable &&) noexcept = default;
+  AliasTable &operator=(AliasTable &&) noexcept = default;
+
+  /**
+   * 使用外部的表项数据(如缓存文件映射)，不复制，调用方保证数据在别名表使用期间有效
+   */
+  static AliasTable View(const Entry *entries, size_t size);
+
+  /**
+   * 使用一个[0, 1)区间的均匀随机数选择索引，
+   * 随机数整数部分选择表项，小数部分决定取表项本身还是其别名
+   */
+  [[nodiscard]] size_t Sample(double random_zero_one) const {
+    double scaled = random_zero_one * static_cast<double>(size_);
+    auto index = static_cast<size_t>(scaled);
+    if (index >= size_) {
+      index = size_ - 1;
+    }
+    const auto &entry = entries_[index];
+    return scaled - static_cast<double>(index) < entry.probability ? index : entry.alias;
+  }
+
+  [[nodiscard]] size_t Size() const { return size_; }
+
+  [[nodiscard]] const Entry *Entries() const { return entries_; }
+
+ private:
+  std::vector<Entry> storage_;
+  const Entry *entries_{};
+  size_t size_{};
+};
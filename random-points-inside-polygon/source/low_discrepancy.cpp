@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "low_discrepancy.h"
+#include "splitmix.h"
+
+using namespace std::string_literals;
+
+namespace {
+
+// 小于1的最大double，置乱后的值舍入到1时使用
+constexpr double kOneMinusEpsilon = 0x1.fffffffffffffp-1;
+
+/**
+ * Sobol序列第2维起的本原多项式次数s、系数a及初始方向数m(Joe-Kuo new-joe-kuo-6.21201)，第1维为van der Corput序列
+ */
+struct SobolPolynomial {
+  unsigned degree;
+  unsigned coefficients;
+  std::array<uint32_t, 2> initial_directions;
+};
+
+constexpr SobolPolynomial kSobolPolynomials[LowDiscrepancySequence::kDimensions - 1] = {
+    {1, 0, {1, 0}},
+    {2, 1, {1, 3}},
+};
+
+constexpr uint32_t kHaltonBases[LowDiscrepancySequence::kDimensions] = {2, 3, 5};
+
+/**
+ * 各维置乱使用的种子
+ */
+std::array<uint64_t, LowDiscrepancySequence::kDimensions> DimensionSeeds(uint64_t seed) {
+  std::array<uint64_t, LowDiscrepancySequence::kDimensions> seeds{};
+  for (size_t dimension = 0; dimension != seeds.size(); ++dimension) {
+    seeds[dimension] = SplitMix64(seed + dimension);
+  }
+  return seeds;
+}
+
+/**
+ * 对32位二进制小数进行Owen置乱，从最高位开始，每一位依据前面各位(置乱前)的哈希值决定是否翻转
+ */
+uint32_t OwenScramble(uint32_t value, uint64_t seed) {
+  uint64_t state = seed;
+  uint32_t result = 0;
+  for (int bit = 31; bit >= 0; --bit) {
+    uint32_t digit = (value >> bit) & 1;
+    result |= (digit ^ static_cast<uint32_t>(state >> 63)) << bit;
+    state = SplitMix64(state + digit);
+  }
+  return result;
+}
+
+/**
+ * index以base为底的倒根，即将index的各位数字依次写到小数点后
+ * 置乱时每一位数字使用由前面各位数字哈希值选择的仿射置换(digit * a + c) mod base，
+ * 原本为0的后续数字也会被置换，因此一直生成到double精度
+ */
+double RadicalInverse(uint64_t index, uint32_t base, bool scramble, uint64_t seed) {
+  double inverse_base = 1.0 / base;
+  double scale = inverse_base;
+  double value = 0;
+  uint64_t state = seed;
+  while (scramble ? scale >= 0x1.0p-53 : index != 0) {
+    auto digit = static_cast<uint32_t>(index % base);
+    index /= base;
+    uint32_t permuted_digit = digit;
+    if (scramble) {
+      auto multiplier = static_cast<uint32_t>(1 + state % (base - 1));
+      auto shift = static_cast<uint32_t>(state / (base - 1) % base);
+      permuted_digit = (digit * multiplier + shift) % base;
+      state = SplitMix64(state + digit);
+    }
+    value += permuted_digit * scale;
+    scale *= inverse_base;
+  }
+  return std::min(value, kOneMinusEpsilon);
+}
+
+}
+
+SobolSequence::SobolSequence(bool scramble, uint64_t seed) : scramble_{scramble}, seeds_{DimensionSeeds(seed)} {
+  for (unsigned bit = 0; bit != kBits; ++bit) {
+    directions_[0][bit] = 1u << (kBits - 1 - bit);
+  }
+  for (size_t dimension = 1; dimension != kDimensions; ++dimension) {
+    const auto &polynomial = kSobolPolynomials[dimension - 1];
+    auto &directions = directions_[dimension];
+    unsigned degree = polynomial.degree;
+    for (unsigned bit = 0; bit != degree; ++bit) {
+      directions[bit] = polynomial.initial_directions[bit] << (kBits - 1 - bit);
+    }
+    for (unsigned bit = degree; bit != kBits; ++bit) {
+      directions[bit] = directions[bit - degree] ^ (directions[bit - degree] >> degree);
+      for (unsigned k = 1; k < degree; ++k) {
+        if ((polynomial.coefficients >> (degree - 1 - k)) & 1) {
+          directions[bit] ^= directions[bit - k];
+        }
+      }
+    }
+  }
+}
+
+void SobolSequence::Sample(uint64_t index, double *values) const {
+  if (index >> kBits != 0) {
+    throw std::out_of_range("Sobol序列最多生成2^32个点"s);
+  }
+  // 按格雷码顺序生成，第index个点为格雷码中各个为1的位对应方向数的异或
+  uint64_t gray_code = index ^ (index >> 1);
+  for (size_t dimension = 0; dimension != kDimensions; ++dimension) {
+    uint32_t value = 0;
+    for (uint64_t bits = gray_code; bits != 0; bits &= bits - 1) {
+      value ^= directions_[dimension][__builtin_ctzll(bits)];
+    }
+    if (scramble_) {
+      value = OwenScramble(value, seeds_[dimension]);
+    }
+    values[dimension] = value * 0x1.0p-32;
+  }
+}
+
+HaltonSequence::HaltonSequence(bool scramble, uint64_t seed) : scramble_{scramble}, seeds_{DimensionSeeds(seed)} {}
+
+void HaltonSequence::Sample(uint64_t index, double *values) const {
+  for (size_t dimension = 0; dimension != kDimensions; ++dimension) {
+    values[dimension] = RadicalInverse(index, kHaltonBases[dimension], scramble_, seeds_[dimension]);
+  }
+}
+
+std::unique_ptr<LowDiscrepancySequence> CreateLowDiscrepancySequence(const std::string &name,
+                                                                     bool scramble,
+                                                                     uint64_t seed) {
+  if (name == "sobol") {
+    return std::make_unique<SobolSequence>(scramble, seed);
+  }
+  if (name == "halton") {
+    return std::make_unique<HaltonSequence>(scramble, seed);
+  }
+  throw std::invalid_argument("不支持的低差异序列："s + name);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * 3维低差异(准随机)序列，第1维用于按面积选择三角形，第2、3维用于三角形内的重心坐标
+ * 第index个点只与index有关，可以任意顺序生成
+ */
+class LowDiscrepancySequence {
+ public:
+  static constexpr size_t kDimensions = 3;
+
+  virtual ~LowDiscrepancySequence() = default;
+
+  /**
+   * 第index个点的各维坐标，均在[0, 1)区间
+   */
+  virtual void Sample(uint64_t index, double *values) const = 0;
+};
+
+/**
+ * Sobol序列，使用Joe-Kuo方向数，32位精度，最多2^32个点
+ * scramble为true时进行Owen嵌套均匀置乱：每一位是否翻转由种子及其前面各位的哈希值决定
+ */
+class SobolSequence : public LowDiscrepancySequence {
+ public:
+  explicit SobolSequence(bool scramble = false, uint64_t seed = 0);
+
+  void Sample(uint64_t index, double *values) const override;
+
+ private:
+  static constexpr unsigned kBits = 32;
+
+  std::array<std::array<uint32_t, kBits>, kDimensions> directions_{};
+  bool scramble_;
+  std::array<uint64_t, kDimensions> seeds_{};
+};
+
+/**
+ * Halton序列，各维依次以2、3、5为底数的倒根
+ * scramble为true时进行Owen嵌套置乱：每一位数字使用由种子及其前面各位数字哈希值选择的仿射置换
+ */
+class HaltonSequence : public LowDiscrepancySequence {
+ public:
+  explicit HaltonSequence(bool scramble = false, uint64_t seed = 0);
+
+  void Sample(uint64_t index, double *values) const override;
+
+ private:
+  bool scramble_;
+  std::array<uint64_t, kDimensions> seeds_{};
+};
+
+/**
+ * 创建指定名称的低差异序列，支持sobol、halton
+ */
+std::unique_ptr<LowDiscrepancySequence> CreateLowDiscrepancySequence(const std::string &name,
+                                                                     bool scramble = false,
+                                                                     uint64_t seed = 0);
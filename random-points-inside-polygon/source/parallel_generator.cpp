@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "parallel_generator.h"
+
+namespace {
+
+using Chunk = std::vector<double>;
+
+/**
+ * 单生产者单消费者的有界队列，Close后所有等待都会返回
+ */
+class BoundedChunkQueue {
+ public:
+  explicit BoundedChunkQueue(size_t capacity) : capacity_{std::max<size_t>(capacity, 1)} {}
+
+  /**
+   * 队列已满时等待，队列关闭时返回false
+   */
+  bool Push(Chunk &&chunk) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    not_full_.wait(lock, [this] { return closed_ || chunks_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    chunks_.push_back(std::move(chunk));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /**
+   * 队列为空时等待，队列关闭且为空时返回false
+   */
+  bool Pop(Chunk &chunk) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    not_empty_.wait(lock, [this] { return closed_ || !chunks_.empty(); });
+    if (chunks_.empty()) {
+      return false;
+    }
+    chunk = std::move(chunks_.front());
+    chunks_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    closed_ = true;
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  size_t capacity_;
+  std::deque<Chunk> chunks_;
+  bool closed_{false};
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+
+}
+
+void GenerateRandomPointsParallel(const ROI &roi,
+                                  size_t n,
+                                  PointWriter &writer,
+                                  const ParallelGenerateOptions &options) {
+  auto threads_num = static_cast<size_t>(std::max(options.threads, 1));
+  size_t chunk_size = std::max<size_t>(options.chunk_size, 1);
+  size_t chunks_num = (n + chunk_size - 1) / chunk_size;
+  threads_num = std::max<size_t>(std::min(threads_num, chunks_num), 1);
+
+  std::vector<std::unique_ptr<BoundedChunkQueue>> queues;
+  for (size_t i = 0; i != threads_num; ++i) {
+    queues.push_back(std::make_unique<BoundedChunkQueue>(options.queue_capacity));
+  }
+  std::vector<std::exception_ptr> errors(threads_num);
+
+  auto worker = [&](size_t thread_index) {
+    try {
+      bool counter_based = options.engine == RandomEngineType::kPhilox;
+      std::vector<uint32_t> seeds{static_cast<uint32_t>(options.seed), static_cast<uint32_t>(options.seed >> 32)};
+      if (!counter_based) {
+        seeds.push_back(static_cast<uint32_t>(thread_index));
+      }
+      std::seed_seq seed_seq(seeds.cbegin(), seeds.cend());
+      WithRandomEngine(options.engine, seed_seq, [&](auto &engine) {
+        for (size_t chunk_index = thread_index; chunk_index < chunks_num; chunk_index += threads_num) {
+          size_t points_num = std::min(chunk_size, n - chunk_index * chunk_size);
+          if constexpr (std::is_same_v<std::decay_t<decltype(engine)>, Philox4x64>) {
+            engine.Seek((options.first_index + chunk_index * chunk_size) * ROI::kRandomNumbersPerPoint);
+          }
+          Chunk chunk(points_num * 2);
+          roi.GenRandomPoints(engine, points_num, chunk.data());
+          if (!queues[thread_index]->Push(std::move(chunk))) {
+            break;
+          }
+        }
+      });
+    } catch (...) {
+      errors[thread_index] = std::current_exception();
+    }
+    queues[thread_index]->Close();
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i != threads_num; ++i) {
+    workers.emplace_back(worker, i);
+  }
+
+  // 按数据块顺序轮流从各线程队列取出并写入
+  std::exception_ptr write_error;
+  try {
+    Chunk chunk;
+    for (size_t chunk_index = 0; chunk_index < chunks_num; ++chunk_index) {
+      if (!queues[chunk_index % threads_num]->Pop(chunk)) {
+        break;
+      }
+      writer.Write(chunk.data(), chunk.size() / 2);
+    }
+  } catch (...) {
+    write_error = std::current_exception();
+  }
+
+  for (auto &queue: queues) {
+    queue->Close();
+  }
+  for (auto &thread: workers) {
+    thread.join();
+  }
+
+  if (write_error) {
+    std::rethrow_exception(write_error);
+  }
+  for (const auto &error: errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "roi.h"
+#include "point_writer.h"
+#include "random_engines.h"
+
+struct ParallelGenerateOptions {
+  // 生成随机点的线程数量
+  int threads{1};
+  // 随机数种子，相同的种子和线程数量生成相同的随机点序列
+  uint64_t seed{};
+  // 随机数引擎
+  RandomEngineType engine{RandomEngineType::kMt19937_64};
+  // 第一个点的序号，只用于计数器引擎(philox)，生成序号为[first_index, first_index + n)的点
+  uint64_t first_index{};
+  // 每个数据块包含的点数量
+  size_t chunk_size{1 << 16};
+  // 每个线程最多缓存的数据块数量，写入跟不上时生成线程等待
+  size_t queue_capacity{4};
+};
+
+/**
+ * 多线程在ROI内生成n个随机点并写入writer
+ * 点数量按数据块轮流分配给各线程，第i个数据块由第i % threads个线程生成，
+ * 每个线程使用以(seed, 线程序号)初始化的独立随机数引擎，写入时按数据块顺序依次取出，
+ * 因此输出只与seed、引擎及线程数量有关
+ * 使用计数器引擎时所有线程使用相同的密钥，每个数据块定位到其第一个点的位置，第i个点只与(seed, i)有关，
+ * 输出与线程数量无关，任意序号范围可以单独重新生成
+ */
+void GenerateRandomPointsParallel(const ROI &roi,
+                                  size_t n,
+                                  PointWriter &writer,
+                                  const ParallelGenerateOptions &options);
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <cpl_error.h>
+#include <cpl_string.h>
+#include <ogrsf_frmts.h>
+
+#include "point_writer.h"
+
+using namespace std::string_literals;
+
+namespace {
+
+/**
+ * 通过OGR写入，整个输出过程复用同一个要素及点对象
+ * 每transaction_size个要素提交一次事务，避免SQLite等驱动每个要素提交一次
+ */
+class OGRPointWriter : public PointWriter {
+ public:
+  OGRPointWriter(const std::string &driver_name, const std::string &path, const PointWriterOptions &options)
+      : transaction_size_{options.transaction_size} {
+    auto driver = GetGDALDriverManager()->GetDriverByName(driver_name.c_str());
+    if (driver == nullptr) {
+      throw std::runtime_error("不支持的驱动："s + driver_name);
+    }
+    GDALDriver::QuietDelete(path.c_str());
+    dataset_.reset(driver->Create(path.c_str(), 0, 0, 0, GDT_Unknown, nullptr));
+    if (dataset_ == nullptr) {
+      throw std::runtime_error("创建数据集失败："s + path);
+    }
+    char **layer_options = nullptr;
+    create_spatial_index_ = options.defer_spatial_index && driver_name == "GPKG";
+    if (create_spatial_index_) {
+      layer_options = CSLAddString(layer_options, "SPATIAL_INDEX=NO");
+    }
+    layer_ = dataset_->CreateLayer("points", nullptr, wkbPoint, layer_options);
+    CSLDestroy(layer_options);
+    if (layer_ == nullptr) {
+      throw std::runtime_error("创建图层失败"s);
+    }
+    if (options.source_fid) {
+      OGRFieldDefn field_defn{"source_fid", OFTInteger64};
+      if (layer_->CreateField(&field_defn) != OGRERR_NONE) {
+        throw std::runtime_error("创建字段失败：source_fid"s);
+      }
+      source_fid_field_ = layer_->GetLayerDefn()->GetFieldIndex("source_fid");
+    }
+    feature_.reset(new OGRFeature(layer_->GetLayerDefn()));
+    point_ = new OGRPoint;
+    feature_->SetGeometryDirectly(point_);
+  }
+
+  void Write(const double *xy, const int64_t *source_fids, size_t n) override {
+    for (size_t i = 0; i != n; ++i) {
+      if (transaction_size_ != 0 && !in_transaction_) {
+        // 不支持事务的驱动(如FlatGeobuf)直接写入
+        in_transaction_ = layer_->StartTransaction() == OGRERR_NONE;
+      }
+      point_->setX(xy[i * 2]);
+      point_->setY(xy[i * 2 + 1]);
+      if (source_fid_field_ >= 0) {
+        if (source_fids != nullptr) {
+          feature_->SetField(source_fid_field_, static_cast<GIntBig>(source_fids[i]));
+        } else {
+          feature_->SetFieldNull(source_fid_field_);
+        }
+      }
+      feature_->SetFID(OGRNullFID);
+      if (layer_->CreateFeature(feature_.get()) != OGRERR_NONE) {
+        throw std::runtime_error("创建要素失败"s);
+      }
+      if (in_transaction_ && ++transaction_features_ == transaction_size_) {
+        Commit();
+      }
+    }
+  }
+
+  void Close() override {
+    if (in_transaction_) {
+      Commit();
+    }
+    if (create_spatial_index_) {
+      // 一次性批量建立空间索引
+      std::string sql = "SELECT CreateSpatialIndex('"s + layer_->GetName() + "', '" + layer_->GetGeometryColumn() + "')";
+      CPLErrorReset();
+      dataset_->ReleaseResultSet(dataset_->ExecuteSQL(sql.c_str(), nullptr, nullptr));
+      // ExecuteSQL对失败的SQL只报告CPLError
+      if (CPLGetLastErrorType() >= CE_Failure) {
+        throw std::runtime_error("建立空间索引失败："s + CPLGetLastErrorMsg());
+      }
+    }
+    feature_.reset();
+    dataset_.reset();
+  }
+
+ private:
+  std::unique_ptr<GDALDataset> dataset_;
+  OGRLayer *layer_{};
+  OGRFeatureUniquePtr feature_;
+  // 由feature_持有
+  OGRPoint *point_{};
+  int source_fid_field_{-1};
+  size_t transaction_size_;
+  size_t transaction_features_{};
+  bool in_transaction_{false};
+  bool create_spatial_index_{false};
+
+  void Commit() {
+    if (layer_->CommitTransaction() != OGRERR_NONE) {
+      throw std::runtime_error("提交事务失败"s);
+    }
+    in_transaction_ = false;
+    transaction_features_ = 0;
+  }
+};
+
+/**
+ * 带大缓冲区的文件输出，缓冲区满时整块写入文件
+ */
+class BufferedPointWriter : public PointWriter {
+ public:
+  explicit BufferedPointWriter(const std::string &path) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+      throw std::runtime_error("无法创建文件："s + path);
+    }
+    buffer_.reserve(kBufferSize);
+  }
+
+  // 未调用Close()时仍写出缓冲区中的点，析构函数不能抛出异常，失败只输出错误信息
+  ~BufferedPointWriter() override {
+    if (file_ != nullptr) {
+      try {
+        BufferedPointWriter::Close();
+      } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+      }
+    }
+  }
+
+  void Close() override {
+    Flush();
+    if (std::fclose(file_) != 0) {
+      file_ = nullptr;
+      throw std::runtime_error("写入文件失败"s);
+    }
+    file_ = nullptr;
+  }
+
+ protected:
+  static constexpr size_t kBufferSize = 8 << 20;
+  // 单个点格式化后的最大长度
+  static constexpr size_t kMaxRecordSize = 256;
+
+  void Append(const char *data, size_t size) {
+    buffer_.insert(buffer_.end(), data, data + size);
+  }
+
+  void Append(double value) {
+    char chars[32];
+    auto result = std::to_chars(chars, chars + sizeof(chars), value);
+    Append(chars, result.ptr - chars);
+  }
+
+  void Append(int64_t value) {
+    char chars[24];
+    auto result = std::to_chars(chars, chars + sizeof(chars), value);
+    Append(chars, result.ptr - chars);
+  }
+
+  // 保证缓冲区可以再容纳一个点
+  void Reserve() {
+    if (buffer_.size() + kMaxRecordSize > kBufferSize) {
+      Flush();
+    }
+  }
+
+  void Flush() {
+    if (!buffer_.empty() && std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+      throw std::runtime_error("写入文件失败"s);
+    }
+    buffer_.clear();
+  }
+
+ private:
+  std::FILE *file_{};
+  std::vector<char> buffer_;
+};
+
+class CsvPointWriter : public BufferedPointWriter {
+ public:
+  CsvPointWriter(const std::string &path, bool source_fid) : BufferedPointWriter(path), source_fid_{source_fid} {
+    if (source_fid_) {
+      Append("x,y,source_fid\n", 15);
+    } else {
+      Append("x,y\n", 4);
+    }
+  }
+
+  void Write(const double *xy, const int64_t *source_fids, size_t n) override {
+    for (size_t i = 0; i != n; ++i) {
+      Reserve();
+      Append(xy[i * 2]);
+      Append(",", 1);
+      Append(xy[i * 2 + 1]);
+      if (source_fid_) {
+        Append(",", 1);
+        if (source_fids != nullptr) {
+          Append(source_fids[i]);
+        }
+      }
+      Append("\n", 1);
+    }
+  }
+
+ private:
+  bool source_fid_;
+};
+
+class GeoJSONSeqPointWriter : public BufferedPointWriter {
+ public:
+  GeoJSONSeqPointWriter(const std::string &path, bool source_fid)
+      : BufferedPointWriter(path), source_fid_{source_fid} {}
+
+  void Write(const double *xy, const int64_t *source_fids, size_t n) override {
+    static const char kPrefix[] = R"({"type":"Feature","properties":{)";
+    static const char kSourceFid[] = R"("source_fid":)";
+    static const char kGeometry[] = R"(},"geometry":{"type":"Point","coordinates":[)";
+    static const char kSuffix[] = "]}}\n";
+    for (size_t i = 0; i != n; ++i) {
+      Reserve();
+      Append(kPrefix, sizeof(kPrefix) - 1);
+      if (source_fid_) {
+        Append(kSourceFid, sizeof(kSourceFid) - 1);
+        if (source_fids != nullptr) {
+          Append(source_fids[i]);
+        } else {
+          Append("null", 4);
+        }
+      }
+      Append(kGeometry, sizeof(kGeometry) - 1);
+      Append(xy[i * 2]);
+      Append(",", 1);
+      Append(xy[i * 2 + 1]);
+      Append(kSuffix, sizeof(kSuffix) - 1);
+    }
+  }
+
+ private:
+  bool source_fid_;
+};
+
+class BinaryPointWriter : public BufferedPointWriter {
+ public:
+  BinaryPointWriter(const std::string &path, bool source_fid) : BufferedPointWriter(path), source_fid_{source_fid} {}
+
+  void Write(const double *xy, const int64_t *source_fids, size_t n) override {
+    for (size_t i = 0; i != n; ++i) {
+      Reserve();
+      AppendLittleEndian(xy[i * 2]);
+      AppendLittleEndian(xy[i * 2 + 1]);
+      if (source_fid_) {
+        AppendLittleEndian(source_fids != nullptr ? source_fids[i] : int64_t{OGRNullFID});
+      }
+    }
+  }
+
+ private:
+  bool source_fid_;
+
+  template<typename T>
+  void AppendLittleEndian(T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    std::reverse(bytes, bytes + sizeof(T));
+#endif
+    Append(bytes, sizeof(T));
+  }
+};
+
+}
+
+std::unique_ptr<PointWriter> CreatePointWriter(const std::string &format,
+                                               const std::string &path,
+                                               const PointWriterOptions &options) {
+  if (format == "gpkg") {
+    return std::make_unique<OGRPointWriter>("GPKG", path, options);
+  }
+  if (format == "flatgeobuf") {
+    return std::make_unique<OGRPointWriter>("FlatGeobuf", path, options);
+  }
+  if (format == "csv") {
+    return std::make_unique<CsvPointWriter>(path, options.source_fid);
+  }
+  if (format == "geojsonseq") {
+    return std::make_unique<GeoJSONSeqPointWriter>(path, options.source_fid);
+  }
+  if (format == "binary") {
+    return std::make_unique<BinaryPointWriter>(path, options.source_fid);
+  }
+  throw std::runtime_error("不支持的输出格式："s + format);
+}
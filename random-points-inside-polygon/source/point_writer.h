@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * 随机点输出，点坐标以交错数组(x0, y0, x1, y1, ...)批量写入
+ */
+class PointWriter {
+ public:
+  virtual ~PointWriter() = default;
+
+  /**
+   * 写入n个点，source_fids为每个点所属要素的FID，输出不包含FID字段时忽略，
+   * 包含FID字段而source_fids为nullptr时写入空值
+   */
+  virtual void Write(const double *xy, const int64_t *source_fids, size_t n) = 0;
+
+  void Write(const double *xy, size_t n) {
+    Write(xy, nullptr, n);
+  }
+
+  /**
+   * 写入缓冲区中剩余的数据并关闭输出
+   */
+  virtual void Close() = 0;
+};
+
+struct PointWriterOptions {
+  // OGR输出每个事务包含的要素数量，0表示不使用事务(每个要素单独提交)
+  size_t transaction_size{100000};
+  // gpkg：创建图层时不建立空间索引，写入完成后一次性批量建立R-tree
+  bool defer_spatial_index{false};
+  // 输出source_fid字段，记录每个点所属要素的FID
+  bool source_fid{false};
+};
+
+/**
+ * 创建指定格式的输出，支持的格式：
+ * gpkg、flatgeobuf：通过OGR写入
+ * csv：每行一个点"x,y"，输出FID时为"x,y,source_fid"
+ * geojsonseq：每行一个GeoJSON Point要素(newline-delimited GeoJSON)，FID保存在properties中
+ * binary：每个点两个小端序double(x, y)，输出FID时其后再加一个小端序int64，无文件头
+ */
+std::unique_ptr<PointWriter> CreatePointWriter(const std::string &format,
+                                               const std::string &path,
+                                               const PointWriterOptions &options = {});
@@ -0,0 +1,140 @@
+#include <stdexcept>
+#include <vector>
+
+#include "random_engines.h"
+
+using namespace std::string_literals;
+
+namespace {
+
+/**
+ * 从seed_seq生成n个64位种子
+ */
+void GenerateSeeds(std::seed_seq &seed_seq, uint64_t *seeds, size_t n) {
+  std::vector<uint32_t> words(n * 2);
+  seed_seq.generate(words.begin(), words.end());
+  for (size_t i = 0; i != n; ++i) {
+    seeds[i] = (static_cast<uint64_t>(words[i * 2]) << 32) | words[i * 2 + 1];
+  }
+}
+
+}
+
+Xoshiro256PlusPlus::Xoshiro256PlusPlus(std::seed_seq &seed_seq) {
+  GenerateSeeds(seed_seq, state_, 4);
+  // 状态不能全为0
+  if ((state_[0] | state_[1] | state_[2] | state_[3]) == 0) {
+    state_[0] = 1;
+  }
+}
+
+Pcg64::Pcg64(std::seed_seq &seed_seq) {
+  uint64_t seeds[4];
+  GenerateSeeds(seed_seq, seeds, 4);
+  // 与PCG参考实现pcg_setseq相同：增量取奇数，状态从0开始加入种子
+  increment_ = (((static_cast<UInt128>(seeds[2]) << 64) | seeds[3]) << 1) | 1;
+  state_ = 0;
+  Step();
+  state_ += (static_cast<UInt128>(seeds[0]) << 64) | seeds[1];
+  Step();
+}
+
+void Pcg64::Step() {
+  constexpr UInt128 kMultiplier = (static_cast<UInt128>(2549297995355413924ULL) << 64) | 4865540595714422341ULL;
+  state_ = state_ * kMultiplier + increment_;
+}
+
+BatchedUniformGenerator::BatchedUniformGenerator(std::seed_seq &seed_seq) {
+  uint64_t seeds[4 * kLanes];
+  GenerateSeeds(seed_seq, seeds, 4 * kLanes);
+  for (size_t lane = 0; lane != kLanes; ++lane) {
+    for (size_t i = 0; i != 4; ++i) {
+      state_[i][lane] = seeds[lane * 4 + i];
+    }
+    if ((state_[0][lane] | state_[1][lane] | state_[2][lane] | state_[3][lane]) == 0) {
+      state_[0][lane] = 1;
+    }
+  }
+}
+
+void BatchedUniformGenerator::Refill() {
+  uint64_t s0[kLanes], s1[kLanes], s2[kLanes], s3[kLanes];
+  for (size_t lane = 0; lane != kLanes; ++lane) {
+    s0[lane] = state_[0][lane];
+    s1[lane] = state_[1][lane];
+    s2[lane] = state_[2][lane];
+    s3[lane] = state_[3][lane];
+  }
+  // 每次迭代各路同时前进一步，输出依次交错存放
+  for (size_t offset = 0; offset != kBufferSize; offset += kLanes) {
+    for (size_t lane = 0; lane != kLanes; ++lane) {
+      buffer_[offset + lane] = Xoshiro256PlusPlus::RotateLeft(s0[lane] + s3[lane], 23) + s0[lane];
+      uint64_t t = s1[lane] << 17;
+      s2[lane] ^= s0[lane];
+      s3[lane] ^= s1[lane];
+      s1[lane] ^= s2[lane];
+      s0[lane] ^= s3[lane];
+      s2[lane] ^= t;
+      s3[lane] = Xoshiro256PlusPlus::RotateLeft(s3[lane], 45);
+    }
+  }
+  for (size_t lane = 0; lane != kLanes; ++lane) {
+    state_[0][lane] = s0[lane];
+    state_[1][lane] = s1[lane];
+    state_[2][lane] = s2[lane];
+    state_[3][lane] = s3[lane];
+  }
+  position_ = 0;
+}
+
+Philox4x64::Philox4x64(std::seed_seq &seed_seq) {
+  GenerateSeeds(seed_seq, key_, 2);
+}
+
+void Philox4x64::Block(const uint64_t key[2], uint64_t counter, uint64_t result[4]) {
+  __extension__ using UInt128 = unsigned __int128;
+  constexpr uint64_t kMultiplier0 = 0xD2E7470EE14C6C93ULL;
+  constexpr uint64_t kMultiplier1 = 0xCA5A826395121157ULL;
+  constexpr uint64_t kWeyl0 = 0x9E3779B97F4A7C15ULL;
+  constexpr uint64_t kWeyl1 = 0xBB67AE8584CAA73BULL;
+
+  uint64_t c0 = counter, c1 = 0, c2 = 0, c3 = 0;
+  uint64_t k0 = key[0], k1 = key[1];
+  for (int round = 0; round != 10; ++round) {
+    if (round != 0) {
+      k0 += kWeyl0;
+      k1 += kWeyl1;
+    }
+    UInt128 product0 = static_cast<UInt128>(kMultiplier0) * c0;
+    UInt128 product1 = static_cast<UInt128>(kMultiplier1) * c2;
+    uint64_t next0 = static_cast<uint64_t>(product1 >> 64) ^ c1 ^ k0;
+    uint64_t next2 = static_cast<uint64_t>(product0 >> 64) ^ c3 ^ k1;
+    c1 = static_cast<uint64_t>(product1);
+    c3 = static_cast<uint64_t>(product0);
+    c0 = next0;
+    c2 = next2;
+  }
+  result[0] = c0;
+  result[1] = c1;
+  result[2] = c2;
+  result[3] = c3;
+}
+
+RandomEngineType ParseRandomEngineType(const std::string &name) {
+  if (name == "mt19937_64") {
+    return RandomEngineType::kMt19937_64;
+  }
+  if (name == "xoshiro256pp") {
+    return RandomEngineType::kXoshiro256PlusPlus;
+  }
+  if (name == "pcg64") {
+    return RandomEngineType::kPcg64;
+  }
+  if (name == "batched") {
+    return RandomEngineType::kBatched;
+  }
+  if (name == "philox") {
+    return RandomEngineType::kPhilox;
+  }
+  throw std::invalid_argument("不支持的随机数引擎："s + name);
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+
+/**
+ * xoshiro256++，256位状态，周期2^256-1，只使用加法、移位、异或及循环移位
+ */
+class Xoshiro256PlusPlus {
+ public:
+  using result_type = uint64_t;
+
+  explicit Xoshiro256PlusPlus(std::seed_seq &seed_seq);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    uint64_t result = RotateLeft(state_[0] + state_[3], 23) + state_[0];
+    uint64_t t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = RotateLeft(state_[3], 45);
+    return result;
+  }
+
+  static uint64_t RotateLeft(uint64_t value, int shift) {
+    return (value << shift) | (value >> (64 - shift));
+  }
+
+ private:
+  uint64_t state_[4];
+};
+
+/**
+ * PCG64(PCG XSL RR 128/64)，128位线性同余状态，输出时高低64位异或后按最高6位循环右移
+ */
+class Pcg64 {
+ public:
+  using result_type = uint64_t;
+
+  explicit Pcg64(std::seed_seq &seed_seq);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    Step();
+    auto rotation = static_cast<unsigned>(state_ >> 122);
+    uint64_t value = static_cast<uint64_t>(state_ >> 64) ^ static_cast<uint64_t>(state_);
+    return (value >> rotation) | (value << ((64 - rotation) & 63));
+  }
+
+ private:
+  __extension__ using UInt128 = unsigned __int128;
+
+  UInt128 state_{};
+  UInt128 increment_{};
+
+  void Step();
+};
+
+/**
+ * 批量生成器：4个交错的xoshiro256++状态按数组存放，整块填充缓冲区，循环可被编译器向量化(如AVX2每条指令处理4路)，
+ * 转换为double时将随机数高52位放入[1, 2)区间double的尾数再减1，不需要除法
+ */
+class BatchedUniformGenerator {
+ public:
+  using result_type = uint64_t;
+
+  explicit BatchedUniformGenerator(std::seed_seq &seed_seq);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    if (position_ == kBufferSize) {
+      Refill();
+    }
+    return buffer_[position_++];
+  }
+
+  /**
+   * 生成n个[0, 1)区间的均匀随机double，与逐个调用operator()使用相同的随机数序列
+   */
+  void FillUniform(double *values, size_t n) {
+    while (n != 0) {
+      if (position_ == kBufferSize) {
+        Refill();
+      }
+      size_t count = std::min(n, kBufferSize - position_);
+      const uint64_t *bits = buffer_ + position_;
+      for (size_t i = 0; i != count; ++i) {
+        uint64_t mantissa = (bits[i] >> 12) | 0x3ff0000000000000ULL;
+        double value;
+        std::memcpy(&value, &mantissa, sizeof(double));
+        values[i] = value - 1.0;
+      }
+      position_ += count;
+      values += count;
+      n -= count;
+    }
+  }
+
+ private:
+  static constexpr size_t kLanes = 4;
+  static constexpr size_t kBufferSize = 1024;
+
+  // 各路状态的第i个分量存放在state_[i]中
+  uint64_t state_[4][kLanes];
+  alignas(64) uint64_t buffer_[kBufferSize];
+  size_t position_{kBufferSize};
+
+  void Refill();
+};
+
+/**
+ * 基于计数器的Philox4x64-10：第k个64位随机数为以种子为密钥、k / 4为计数器的分组置换结果的第k % 4个分量，
+ * 只与(密钥, k)有关，可通过Seek直接定位到任意位置，不需要依次生成前面的随机数
+ */
+class Philox4x64 {
+ public:
+  using result_type = uint64_t;
+
+  explicit Philox4x64(std::seed_seq &seed_seq);
+
+  Philox4x64(uint64_t key0, uint64_t key1) : key_{key0, key1} {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    if (!block_valid_ || (position_ >> 2) != block_counter_) {
+      Generate(position_ >> 2);
+    }
+    return block_[position_++ & 3];
+  }
+
+  /**
+   * 定位到第position个随机数
+   */
+  void Seek(uint64_t position) {
+    position_ = position;
+  }
+
+  /**
+   * 以key为密钥对计数器(counter, 0, 0, 0)进行10轮Philox置换
+   */
+  static void Block(const uint64_t key[2], uint64_t counter, uint64_t result[4]);
+
+ private:
+  uint64_t key_[2];
+  uint64_t position_{};
+  uint64_t block_counter_{};
+  bool block_valid_{false};
+  uint64_t block_[4]{};
+
+  void Generate(uint64_t counter) {
+    Block(key_, counter, block_);
+    block_counter_ = counter;
+    block_valid_ = true;
+  }
+};
+
+/**
+ * 可在运行时选择的随机数引擎
+ */
+enum class RandomEngineType {
+  kMt19937_64,
+  kXoshiro256PlusPlus,
+  kPcg64,
+  kBatched,
+  kPhilox,
+};
+
+/**
+ * 引擎名称：mt19937_64、xoshiro256pp、pcg64、batched、philox
+ */
+RandomEngineType ParseRandomEngineType(const std::string &name);
+
+/**
+ * 以seed_seq初始化指定类型的引擎并调用function(engine)
+ */
+template<typename Function>
+void WithRandomEngine(RandomEngineType type, std::seed_seq &seed_seq, Function &&function) {
+  switch (type) {
+    case RandomEngineType::kXoshiro256PlusPlus: {
+      Xoshiro256PlusPlus engine{seed_seq};
+      function(engine);
+    };
+      break;
+    case RandomEngineType::kPcg64: {
+      Pcg64 engine{seed_seq};
+      function(engine);
+    };
+      break;
+    case RandomEngineType::kBatched: {
+      BatchedUniformGenerator engine{seed_seq};
+      function(engine);
+    };
+      break;
+    case RandomEngineType::kPhilox: {
+      Philox4x64 engine{seed_seq};
+      function(engine);
+    };
+      break;
+    default: {
+      std::mt19937_64 engine{seed_seq};
+      function(engine);
+    }
+  }
+}
+
+template<typename URNG, typename = void>
+struct HasFillUniform : std::false_type {};
+
+template<typename URNG>
+struct HasFillUniform<URNG, std::void_t<decltype(std::declval<URNG &>().FillUniform(std::declval<double *>(), size_t{}))>>
+    : std::true_type {};
+
+/**
+ * 生成n个[0, 1)区间的均匀随机double写入values：
+ * 引擎提供FillUniform时整块生成，64位输出的引擎取高53位乘以2^-53，
+ * 其他引擎(如std::mt19937)使用std::uniform_real_distribution
+ */
+template<typename URNG>
+void FillUniform(URNG &engine, double *values, size_t n) {
+  if constexpr (HasFillUniform<URNG>::value) {
+    engine.FillUniform(values, n);
+  } else if constexpr (URNG::min() == 0 && URNG::max() == std::numeric_limits<uint64_t>::max()) {
+    for (size_t i = 0; i != n; ++i) {
+      values[i] = static_cast<double>(static_cast<uint64_t>(engine()) >> 11) * 0x1.0p-53;
+    }
+  } else {
+    std::uniform_real_distribution<double> rand_zero_one{0.0, 1.0};
+    for (size_t i = 0; i != n; ++i) {
+      values[i] = rand_zero_one(engine);
+    }
+  }
+}
@@ -1,14 +1,23 @@
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <exception>
 #include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
 
+#include <cpl_conv.h>
+#include <ogr_spatialref.h>
 #include <ogrsf_frmts.h>
 
 #include "roi.h"
+#include "roi_cache.h"
 #include "mapbox/earcut.hpp"
 
 using namespace std::string_literals;
 
-using IterateGeomHandler = void (*)(OGRGeometry *, void *data);
+using IterateGeomHandler = void (*)(OGRFeature *, void *data);
 
 void IterateGeom(const std::string &vector_file, IterateGeomHandler geom_handler, void *geom_handler_data) {
   std::unique_ptr<GDALDataset> dataset{(GDALDataset *) GDALOpenEx(vector_file.c_str(), GDAL_OF_VECTOR, nullptr, nullptr,
@@ -23,108 +32,401 @@ void IterateGeom(const std::string &vector_file, IterateGeomHandler geom_handler
   for (int i = 0; i != dataset->GetLayerCount(); ++i) {
     auto layer = dataset->GetLayer(i);
     for (auto &feat: layer) {
-      geom_handler(feat->GetGeometryRef(), geom_handler_data);
+      geom_handler(feat.get(), geom_handler_data);
     }
   }
 }
 
-void AddPolygonToROI(OGRGeometry *geometry, void *data) {
-  auto polygons = (ROI::PolygonArray *) data;
+struct AddPolygonData {
+  ROI::RingsArray *rings_array;
+  double curve_step_degrees;
+  // 第一个带坐标系的几何对象的坐标系
+  std::unique_ptr<OGRSpatialReference> spatial_ref;
+  // 需要读取的属性字段，为空时不读取
+  std::string attribute_field;
+  // 包含多边形的要素第一个多边形在rings_array中的索引、FID及属性字段值
+  std::vector<size_t> feature_polygon_offsets;
+  std::vector<int64_t> feature_fids;
+  std::vector<double> feature_values;
+};
 
-  switch (geometry->getGeometryType()) {
-    case wkbPolygon:
-    case wkbPolygon25D:
-    case wkbPolygonM:
-    case wkbPolygonZM: {
+void AddPolygonToROI(OGRFeature *feature, void *data) {
+  auto add_polygon_data = (AddPolygonData *) data;
+  auto geometry = feature->GetGeometryRef();
+  if (add_polygon_data->spatial_ref == nullptr && geometry != nullptr && geometry->getSpatialReference() != nullptr) {
+    add_polygon_data->spatial_ref.reset(geometry->getSpatialReference()->Clone());
+  }
+  size_t polygons_num = add_polygon_data->rings_array->size();
+  ROI::AppendGeometryRings(geometry, add_polygon_data->curve_step_degrees, *add_polygon_data->rings_array);
+  if (add_polygon_data->rings_array->size() == polygons_num) {
+    return;
+  }
+
+  add_polygon_data->feature_polygon_offsets.push_back(polygons_num);
+  add_polygon_data->feature_fids.push_back(feature->GetFID());
+  if (!add_polygon_data->attribute_field.empty()) {
+    int field_index = feature->GetFieldIndex(add_polygon_data->attribute_field.c_str());
+    if (field_index < 0) {
+      throw std::runtime_error("要素没有字段："s + add_polygon_data->attribute_field);
+    }
+    add_polygon_data->feature_values.push_back(
+        feature->IsFieldSetAndNotNull(field_index) ? feature->GetFieldAsDouble(field_index) : 0.0);
+  }
+}
+
+void ROI::AppendGeometryRings(OGRGeometry *geometry, double curve_step_degrees, RingsArray &rings_array) {
+  if (geometry == nullptr) {
+    return;
+  }
+
+  switch (wkbFlatten(geometry->getGeometryType())) {
+    case wkbPolygon: {
       auto polygon = geometry->toPolygon();
-      polygons->emplace_back(polygon->clone());
+      if (polygon->getExteriorRing() != nullptr) {
+        rings_array.push_back(ROI::ReadPolygonCoords(polygon));
+      }
+    };
+      break;
+    case wkbCurvePolygon: {
+      std::unique_ptr<OGRGeometry> linear_geometry{geometry->getLinearGeometry(curve_step_degrees)};
+      if (linear_geometry != nullptr && wkbFlatten(linear_geometry->getGeometryType()) == wkbPolygon) {
+        ROI::AppendGeometryRings(linear_geometry.get(), curve_step_degrees, rings_array);
+      }
+    };
+      break;
+    case wkbMultiPolygon:
+    case wkbMultiSurface:
+    case wkbGeometryCollection: {
+      auto collection = geometry->toGeometryCollection();
+      for (int i = 0; i != collection->getNumGeometries(); ++i) {
+        ROI::AppendGeometryRings(collection->getGeometryRef(i), curve_step_degrees, rings_array);
+      }
     };
       break;
     default: {}
   }
 }
 
-ROI::ROI(const std::string &roi_path) {
-  // 读取矢量数据所有多边形
-  IterateGeom(roi_path, AddPolygonToROI, &polygon_array_);
+namespace {
 
-  // 读取所有多边形坐标
-  for (auto &polygon: polygon_array_) {
-    polygon_rings_array_.push_back(ROI::ReadPolygonCoords(polygon.get()));
-  }
-  // 对多边形进行三角剖分
-  for (const auto &polygon_coords: polygon_rings_array_) {
-    polygon_triangulation_aray_.push_back(mapbox::earcut<ROI::Triangulation_N>(polygon_coords));
+std::atomic<uint64_t> next_roi_id{1};
+
+std::string SrsToWkt(const OGRSpatialReference *srs) {
+  if (srs == nullptr) {
+    return {};
   }
-  // 计算每个多边形的三角剖分三角形面积累加
-  for (size_t i = 0; i != polygon_triangulation_aray_.size(); ++i) {
-    std::vector<Point> polygon_vertices;
-    for (const auto &polygon_ring: polygon_rings_array_[i]) {
+  char *wkt = nullptr;
+  srs->exportToWkt(&wkt);
+  std::string result = wkt == nullptr ? "" : wkt;
+  CPLFree(wkt);
+  return result;
+}
+
+// 三角剖分时每个任务包含的多边形数量
+constexpr size_t kTriangulationChunkSize = 64;
+
+/**
+ * 一组连续多边形的三角剖分结果
+ */
+struct TriangulationChunk {
+  std::vector<ROI::Triangle> triangles;
+  std::vector<double> triangle_areas;
+  std::vector<size_t> polygon_triangle_counts;
+};
+
+/**
+ * 对[begin, end)范围内的多边形进行三角剖分，剖分后释放多边形坐标
+ * earcut在同一线程内复用，避免每个多边形重新分配索引数组
+ */
+void TriangulatePolygons(ROI::RingsArray &rings_array,
+                         size_t begin,
+                         size_t end,
+                         mapbox::detail::Earcut<ROI::Triangulation_N> &earcut,
+                         TriangulationChunk &chunk) {
+  std::vector<ROI::Point> polygon_vertices;
+  for (size_t i = begin; i != end; ++i) {
+    auto &polygon_coords = rings_array[i];
+    polygon_vertices.clear();
+    for (const auto &polygon_ring: polygon_coords) {
       polygon_vertices.insert(polygon_vertices.cend(), polygon_ring.cbegin(), polygon_ring.cend());
     }
-    polygon_vertices_array_.push_back(polygon_vertices);
-
-    polygon_triangle_area_acc_array_.push_back(PolygonTriangleAreaAccArray::value_type{});
-    auto &polygon_acc_area = *(polygon_triangle_area_acc_array_.end() - 1);
-
-    const auto &triangles_indices = polygon_triangulation_aray_[i];
-    auto triangles_number = static_cast<size_t>(triangles_indices.size() / 3);
-    for (size_t j = 0; j != triangles_number; ++j) {
-      const auto &p1 = polygon_vertices[triangles_indices[j * 3]];
-      const auto &p2 = polygon_vertices[triangles_indices[j * 3 + 1]];
-      const auto &p3 = polygon_vertices[triangles_indices[j * 3 + 2]];
-      double triangle_area = CalculateTriangleArea(
-          p1[0], p1[1],
-          p2[0], p2[1],
-          p3[0], p3[1]);
-      if (polygon_acc_area.empty()) {
-        polygon_acc_area.push_back(triangle_area);
-      } else {
-        double total_area = triangle_area + (*(polygon_acc_area.end() - 1));
-        polygon_acc_area.push_back(total_area);
+    earcut(polygon_coords);
+    const auto &triangles_indices = earcut.indices;
+    for (size_t j = 0; j + 2 < triangles_indices.size(); j += 3) {
+      ROI::Triangle triangle{
+          polygon_vertices[triangles_indices[j]],
+          polygon_vertices[triangles_indices[j + 1]],
+          polygon_vertices[triangles_indices[j + 2]],
+      };
+      chunk.triangles.push_back(triangle);
+    }
+    chunk.polygon_triangle_counts.push_back(triangles_indices.size() / 3);
+    ROI::Rings{}.swap(polygon_coords);
+  }
+  chunk.triangle_areas.resize(chunk.triangles.size());
+  CalculateTriangleAreas(chunk.triangles.data(), chunk.triangles.size(), chunk.triangle_areas.data());
+}
+
+}
+
+ROI::ROI(const std::string &roi_path, const ROIOptions &options) : id_{next_roi_id++} {
+  std::string cache_key, cache_path;
+  if (!options.cache_dir.empty()) {
+    cache_key = ROICache::Key(roi_path, options);
+    if (!cache_key.empty()) {
+      cache_path = ROICache::Path(options.cache_dir, cache_key);
+      cache_ = ROICache::Open(cache_path, cache_key);
+    }
+  }
+
+  if (cache_ != nullptr) {
+    triangles_ = cache_->Triangles();
+    triangles_num_ = cache_->TrianglesNum();
+    triangle_alias_table_ = AliasTable::View(cache_->AliasEntries(), triangles_num_);
+    feature_triangle_offsets_.assign(cache_->FeatureTriangleOffsets(),
+                                     cache_->FeatureTriangleOffsets() + cache_->FeaturesNum() + 1);
+    feature_fids_.assign(cache_->FeatureFids(), cache_->FeatureFids() + cache_->FeaturesNum());
+    if (cache_->FeatureValues() != nullptr) {
+      feature_values_.assign(cache_->FeatureValues(), cache_->FeatureValues() + cache_->FeaturesNum());
+    }
+    if (options.equal_area) {
+      source_srs_ = std::make_unique<OGRSpatialReference>();
+      equal_area_srs_ = std::make_unique<OGRSpatialReference>();
+      source_srs_->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+      equal_area_srs_->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+      if (source_srs_->importFromWkt(cache_->SourceSrsWkt().c_str()) != OGRERR_NONE
+          || equal_area_srs_->importFromWkt(cache_->EqualAreaSrsWkt().c_str()) != OGRERR_NONE) {
+        throw std::runtime_error("三角剖分缓存中的坐标系无效："s + cache_path);
       }
     }
+    return;
   }
 
-  // 多边形面积累积数组
-  for (const auto &polygon_triangle_area_acc: polygon_triangle_area_acc_array_) {
-    double polygon_area = (*(polygon_triangle_area_acc.end() - 1));
-    if (polygon_area_acc_array_.empty()) {
-      polygon_area_acc_array_.push_back(polygon_area);
-    } else {
-      polygon_area += (*(polygon_area_acc_array_.end() - 1));
-      polygon_area_acc_array_.push_back(polygon_area);
+  Triangulate(roi_path, options);
+  if (!cache_path.empty()) {
+    try {
+      ROICache::Write(cache_path, cache_key, triangles_, triangles_num_, triangle_alias_table_, feature_triangle_offsets_,
+                      feature_fids_, feature_values_, SrsToWkt(source_srs_.get()), SrsToWkt(equal_area_srs_.get()));
+    } catch (const std::exception &e) {
+      std::cerr << "写入三角剖分缓存失败：" << e.what() << std::endl;
     }
   }
 }
 
-std::array<double, 2> ROI::GenRandomPoint() {
-  // 随机选择用于生成随机点的多边形
-  double target_polygon_area = rand_zero_one_(rand_engine_) * (*(polygon_area_acc_array_.end() - 1));
-  int target_polygon_index = ROI::FindLowerOrEqualIndex(polygon_area_acc_array_, target_polygon_area);
-  // 随机选择用于生成随机点的三角形
-  double target_triangle_area =
-      rand_zero_one_(rand_engine_) * (*(polygon_triangle_area_acc_array_[target_polygon_index].end() - 1));
-  int target_triangle_index =
-      ROI::FindLowerOrEqualIndex(polygon_triangle_area_acc_array_[target_polygon_index], target_triangle_area);
-  // 依据三角形重心坐标原理生成三角形内随机点
-  auto polygon_triangulation = polygon_triangulation_aray_[target_polygon_index];
-  double u = rand_zero_one_(rand_engine_), v = rand_zero_one_(rand_engine_);
-  ROI::Point tri_p1 = polygon_vertices_array_[target_polygon_index][polygon_triangulation[target_triangle_index * 3]];
-  ROI::Point
-      tri_p2 = polygon_vertices_array_[target_polygon_index][polygon_triangulation[target_triangle_index * 3 + 1]];
-  ROI::Point
-      tri_p3 = polygon_vertices_array_[target_polygon_index][polygon_triangulation[target_triangle_index * 3 + 2]];
-
-  if (u + v > 1) {
-    u = 1 - u;
-    v = 1 - v;
-  }
-
-  return {
-      u * (tri_p3[0] - tri_p1[0]) + v * (tri_p2[0] - tri_p1[0]) + tri_p1[0],
-      u * (tri_p3[1] - tri_p1[1]) + v * (tri_p2[1] - tri_p1[1]) + tri_p1[1],
+ROI::~ROI() = default;
+
+void ROI::Triangulate(const std::string &roi_path, const ROIOptions &options) {
+  // 逐个要素读取多边形坐标，不保留几何对象
+  RingsArray polygon_rings_array;
+  AddPolygonData add_polygon_data{&polygon_rings_array, options.curve_step_degrees, nullptr, options.attribute_field,
+                                  {}, {}, {}};
+  IterateGeom(roi_path, AddPolygonToROI, &add_polygon_data);
+  if (options.equal_area) {
+    if (add_polygon_data.spatial_ref == nullptr) {
+      throw std::runtime_error("文件："s + roi_path + "没有坐标系，无法使用等积模式"s);
+    }
+    ProjectToEqualArea(add_polygon_data.spatial_ref.get(), polygon_rings_array);
+  }
+
+  // 多线程对多边形进行三角剖分，多边形按固定数量分组，各组结果再按多边形顺序合并，
+  // 因此结果与线程数量无关
+  size_t polygons_num = polygon_rings_array.size();
+  size_t chunks_num = (polygons_num + kTriangulationChunkSize - 1) / kTriangulationChunkSize;
+  std::vector<TriangulationChunk> chunks(chunks_num);
+  std::atomic<size_t> next_chunk{0};
+  auto worker = [&]() {
+    mapbox::detail::Earcut<ROI::Triangulation_N> earcut;
+    for (size_t chunk_index; (chunk_index = next_chunk++) < chunks_num;) {
+      size_t begin = chunk_index * kTriangulationChunkSize;
+      size_t end = std::min(begin + kTriangulationChunkSize, polygons_num);
+      TriangulatePolygons(polygon_rings_array, begin, end, earcut, chunks[chunk_index]);
+    }
+  };
+
+  auto threads_num = std::min(static_cast<size_t>(std::max(options.threads, 1)), std::max<size_t>(chunks_num, 1));
+  std::vector<std::exception_ptr> errors(threads_num);
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < threads_num; ++i) {
+    workers.emplace_back([&worker, &errors, i]() {
+      try {
+        worker();
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
+  try {
+    worker();
+  } catch (...) {
+    errors[0] = std::current_exception();
+  }
+  for (auto &thread: workers) {
+    thread.join();
+  }
+  for (const auto &error: errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // 按多边形顺序合并三角形，三角形总数由各组数量累加得到
+  size_t triangles_num = 0;
+  for (const auto &chunk: chunks) {
+    triangles_num += chunk.triangles.size();
+  }
+  triangles_storage_.reserve(triangles_num);
+  std::vector<double> triangle_areas;
+  triangle_areas.reserve(triangles_num);
+  std::vector<size_t> polygon_triangle_offsets;
+  polygon_triangle_offsets.reserve(polygons_num + 1);
+  for (auto &chunk: chunks) {
+    size_t offset = triangles_storage_.size();
+    for (auto count: chunk.polygon_triangle_counts) {
+      polygon_triangle_offsets.push_back(offset);
+      offset += count;
+    }
+    triangles_storage_.insert(triangles_storage_.cend(), chunk.triangles.cbegin(), chunk.triangles.cend());
+    triangle_areas.insert(triangle_areas.cend(), chunk.triangle_areas.cbegin(), chunk.triangle_areas.cend());
+    chunk = TriangulationChunk{};
+  }
+  polygon_triangle_offsets.push_back(triangles_storage_.size());
+  triangles_ = triangles_storage_.data();
+  triangles_num_ = triangles_storage_.size();
+
+  // 同一要素的多边形连续存放，其三角形也连续，没有三角形的要素去掉
+  auto &feature_polygon_offsets = add_polygon_data.feature_polygon_offsets;
+  feature_polygon_offsets.push_back(polygons_num);
+  for (size_t i = 0; i != add_polygon_data.feature_fids.size(); ++i) {
+    size_t begin = polygon_triangle_offsets[feature_polygon_offsets[i]];
+    size_t end = polygon_triangle_offsets[feature_polygon_offsets[i + 1]];
+    if (begin == end) {
+      continue;
+    }
+    feature_triangle_offsets_.push_back(begin);
+    feature_fids_.push_back(add_polygon_data.feature_fids[i]);
+    if (!add_polygon_data.feature_values.empty()) {
+      feature_values_.push_back(add_polygon_data.feature_values[i]);
+    }
+  }
+  feature_triangle_offsets_.push_back(triangles_num_);
+
+  double total_area = std::accumulate(triangle_areas.cbegin(), triangle_areas.cend(), 0.0);
+  if (triangles_num_ == 0 || !(total_area > 0)) {
+    throw std::runtime_error("文件："s + roi_path + "没有面积大于0的多边形"s);
+  }
+  triangle_alias_table_ = AliasTable(triangle_areas);
+}
+
+AliasTable ROI::FeatureAliasTable(size_t feature_index) const {
+  size_t begin = feature_triangle_offsets_[feature_index];
+  size_t end = feature_triangle_offsets_[feature_index + 1];
+  std::vector<double> areas(end - begin);
+  CalculateTriangleAreas(triangles_ + begin, areas.size(), areas.data());
+  if (!(std::accumulate(areas.cbegin(), areas.cend(), 0.0) > 0)) {
+    throw std::runtime_error("FID为"s + std::to_string(feature_fids_[feature_index]) + "的要素面积为0，无法生成点"s);
+  }
+  return AliasTable(areas);
+}
+
+void ROI::ProjectToEqualArea(OGRSpatialReference *source_srs, RingsArray &rings_array) {
+  source_srs_.reset(source_srs->Clone());
+  source_srs_->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+
+  // 多边形范围中心的经纬度作为投影中心
+  double min_x = HUGE_VAL, min_y = HUGE_VAL, max_x = -HUGE_VAL, max_y = -HUGE_VAL;
+  for (const auto &rings: rings_array) {
+    if (rings.empty()) {
+      continue;
+    }
+    // 外环范围即多边形范围
+    for (const auto &point: rings[0]) {
+      min_x = std::min(min_x, point[0]);
+      min_y = std::min(min_y, point[1]);
+      max_x = std::max(max_x, point[0]);
+      max_y = std::max(max_y, point[1]);
+    }
+  }
+  if (min_x > max_x) {
+    return;
+  }
+  double center_x = (min_x + max_x) / 2, center_y = (min_y + max_y) / 2;
+  std::unique_ptr<OGRSpatialReference> geographic_srs{source_srs_->CloneGeogCS()};
+  geographic_srs->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+  std::unique_ptr<OGRCoordinateTransformation> to_geographic{
+      OGRCreateCoordinateTransformation(source_srs_.get(), geographic_srs.get())};
+  if (to_geographic == nullptr || !to_geographic->Transform(1, &center_x, &center_y)) {
+    throw std::runtime_error("无法计算多边形中心的经纬度"s);
+  }
+
+  equal_area_srs_ = std::make_unique<OGRSpatialReference>();
+  equal_area_srs_->SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+  equal_area_srs_->SetProjCS("ROI Lambert Azimuthal Equal Area");
+  equal_area_srs_->CopyGeogCSFrom(source_srs_.get());
+  equal_area_srs_->SetLAEA(center_y, center_x, 0, 0);
+
+  std::unique_ptr<OGRCoordinateTransformation> to_equal_area{
+      OGRCreateCoordinateTransformation(source_srs_.get(), equal_area_srs_.get())};
+  if (to_equal_area == nullptr) {
+    throw std::runtime_error("无法创建等积投影坐标转换"s);
+  }
+  // 逐个环批量转换坐标
+  std::vector<double> xs, ys;
+  for (auto &rings: rings_array) {
+    for (auto &ring: rings) {
+      xs.resize(ring.size());
+      ys.resize(ring.size());
+      for (size_t i = 0; i != ring.size(); ++i) {
+        xs[i] = ring[i][0];
+        ys[i] = ring[i][1];
+      }
+      if (!to_equal_area->Transform(ring.size(), xs.data(), ys.data())) {
+        throw std::runtime_error("多边形坐标转换到等积投影失败"s);
+      }
+      for (size_t i = 0; i != ring.size(); ++i) {
+        ring[i] = Point{xs[i], ys[i]};
+      }
+    }
+  }
+}
+
+void ROI::InverseProject(size_t n, double *x, double *y) const {
+  // 坐标转换对象不能在多个线程中同时使用，每个线程缓存最近一个ROI的坐标转换
+  struct ThreadTransform {
+    uint64_t roi_id{};
+    std::unique_ptr<OGRCoordinateTransformation> transform;
+    // 各点是否转换成功
+    std::vector<int> success;
   };
+  thread_local ThreadTransform thread_transform;
+  if (thread_transform.roi_id != id_ || thread_transform.transform == nullptr) {
+    thread_transform.transform.reset(OGRCreateCoordinateTransformation(equal_area_srs_.get(), source_srs_.get()));
+    if (thread_transform.transform == nullptr) {
+      throw std::runtime_error("无法创建等积投影逆变换"s);
+    }
+    thread_transform.roi_id = id_;
+  }
+  auto &success = thread_transform.success;
+  success.assign(n, 1);
+  // 转换失败的点坐标为HUGE_VAL，不能作为结果输出
+  bool all_success = thread_transform.transform->Transform(n, x, y, nullptr, success.data()) != 0;
+  for (size_t i = 0; all_success && i != n; ++i) {
+    all_success = success[i] != 0;
+  }
+  if (!all_success) {
+    throw std::runtime_error("随机点从等积投影转换回多边形坐标系失败"s);
+  }
+}
+
+std::array<double, 2> ROI::GenRandomPoint() {
+  return GenRandomPoint(rand_engine_);
+}
+
+void ROI::GenRandomPoints(size_t n, double *xy) {
+  GenRandomPoints(rand_engine_, n, xy);
+}
+
+void ROI::GenRandomPoints(size_t n, double *x, double *y) {
+  GenRandomPoints(rand_engine_, n, x, y);
 }
 
 ROI::Rings ROI::ReadPolygonCoords(OGRPolygon *polygon) {
@@ -147,26 +449,3 @@ ROI::Rings ROI::ReadPolygonCoords(OGRPolygon *polygon) {
 
   return coords;
 }
-
-int ROI::FindLowerOrEqualIndex(const std::vector<double> &arr, double target) {
-  int low = 0, high = static_cast<int>(arr.size() - 1);
-  while (low <= high) {
-    int mid = static_cast<int>((low + high) / 2);
-    if (target < arr[mid])
-      high = mid - 1;
-    else if (target > arr[mid])
-      low = mid + 1;
-    else
-      return mid;
-  }
-  return high + 1;
-}
-
-double CalculateTriangleArea(double x1, double y1, double x2, double y2, double x3, double y3) {
-  // Heron's formula
-  double a = sqrt(pow((x1 - x2), 2) + pow((y1 - y2), 2));
-  double b = sqrt(pow((x1 - x3), 2) + pow((y1 - y3), 2));
-  double c = sqrt(pow((x2 - x3), 2) + pow((y2 - y3), 2));
-  double s = (a + b + c) / 2;
-  return sqrt(s * (s - a) * (s - b) * (s - c));
-}
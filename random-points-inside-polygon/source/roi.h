@@ -1,64 +1,340 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <memory>
+#include <string>
 #include <array>
 #include <random>
 #include <cstdint>
+#include <stdexcept>
 
 #include "ogr_geometry.h"
 
+#include "alias_table.h"
+#include "random_engines.h"
+
+struct ROIOptions {
+  // 曲线多边形线性化时每段圆弧的最大角度，0表示使用GDAL默认值
+  double curve_step_degrees{};
+  // 三角剖分使用的线程数量
+  int threads{1};
+  // 三角剖分结果缓存目录，为空时不使用缓存
+  std::string cache_dir;
+  // 等积模式：在以ROI中心为原点的兰伯特方位等积投影下三角剖分及生成随机点，
+  // 按椭球面上的真实面积均匀分布，生成的点再变换回多边形坐标系
+  bool equal_area{false};
+  // 按要素分配点数量时读取的数值字段，为空时不读取
+  std::string attribute_field;
+};
+
+class ROICache;
+class OGRSpatialReference;
+class LowDiscrepancySequence;
+
 /**
  * 计算区域，可包含多个，使用多个Polygon表示
+ * 支持Polygon、MultiPolygon、GeometryCollection、CurvePolygon及MultiSurface，其余几何类型忽略
  */
 class ROI {
  public:
-  using PolygonArray = std::vector<std::unique_ptr<OGRPolygon>>;
-
   using Point = std::array<double, 2>;
   using Ring = std::vector<Point>;
   // 多边形坐标数组，包括外环和内环坐标
   using Rings = std::vector<Ring>;
   // 多个多边形坐标数组
   using RingsArray = std::vector<Rings>;
-  // 多个多边形三角剖分结果
+  // 三角剖分结果顶点索引类型
   using Triangulation_N = uint32_t;
-  using PolygonTriangulationAray = std::vector<std::vector<Triangulation_N>>;
-  // 每个多边形的三角形(多个)面积累加数组
-  using PolygonTriangleAreaAccArray = std::vector<std::vector<double>>;
+  // 三角形，顶点坐标直接保存在三角形中
+  struct Triangle {
+    Point p1, p2, p3;
+  };
 
-  explicit ROI(const std::string &roi_path);
+  /**
+   * 读取多边形并进行三角剖分，指定缓存目录时优先映射已有的缓存文件，否则剖分后写入缓存
+   */
+  explicit ROI(const std::string &roi_path, const ROIOptions &options = {});
+
+  ~ROI();
+
+  // 每个点依次使用的[0, 1)区间随机数数量：选择三角形及两个重心坐标
+  static constexpr uint64_t kRandomNumbersPerPoint = 3;
 
   /**
    * 在ROI内随机生成点
    */
   std::array<double, 2> GenRandomPoint();
 
+  /**
+   * 使用指定的随机数引擎在ROI内随机生成点，不修改ROI状态，可在多个线程中使用各自的引擎同时调用
+   * 引擎可以是标准库引擎或random_engines.h中的引擎，随机数通过FillUniform转换为[0, 1)区间的double
+   */
+  template<typename URNG>
+  std::array<double, 2> GenRandomPoint(URNG &engine) const;
+
+  /**
+   * 在ROI内批量随机生成n个点，坐标以交错数组(x0, y0, x1, y1, ...)写入xy
+   * 与逐个调用GenRandomPoint使用相同的随机数序列，因此生成的点相同
+   */
+  void GenRandomPoints(size_t n, double *xy);
+
+  template<typename URNG>
+  void GenRandomPoints(URNG &engine, size_t n, double *xy) const;
+
+  /**
+   * 在ROI内批量随机生成n个点，x、y坐标分别写入x、y数组
+   */
+  void GenRandomPoints(size_t n, double *x, double *y);
+
+  template<typename URNG>
+  void GenRandomPoints(URNG &engine, size_t n, double *x, double *y) const;
+
+  /**
+   * 分层抽样：按三角形面积系统分配点数量(面积累加轴上等间隔、统一随机偏移的n个位置)，
+   * 每个三角形内均匀随机生成，各三角形的点数量与期望值相差不超过1
+   */
+  void GenStratifiedPoints(size_t n, uint64_t seed, std::vector<double> &x, std::vector<double> &y) const;
+
+  /**
+   * 网格抖动抽样：将平面划分为面积为总面积/n的正方形网格，每个网格内随机一点，保留位于ROI内的点，
+   * 生成的点数量约为n。网格内的随机点由种子及网格行列号哈希得到，与三角形遍历顺序无关
+   */
+  void GenJitteredGridPoints(size_t n, uint64_t seed, std::vector<double> &x, std::vector<double> &y) const;
+
+  /**
+   * 泊松圆盘抽样：任意两点距离不小于min_distance，使用网格空间哈希检查邻近点，
+   * 生成n个点或连续多次无法放置新点(ROI已饱和)时停止，因此生成的点可能少于n
+   */
+  void GenPoissonDiskPoints(size_t n,
+                            double min_distance,
+                            uint64_t seed,
+                            std::vector<double> &x,
+                            std::vector<double> &y) const;
+
+  /**
+   * 准随机抽样：使用低差异序列的第0至n-1个点，第1维按面积累加值的逆函数选择三角形，
+   * 第2、3维作为三角形内的重心坐标，用于数值积分时误差随点数量下降得比独立随机点快
+   */
+  void GenLowDiscrepancyPoints(const LowDiscrepancySequence &sequence,
+                               size_t n,
+                               std::vector<double> &x,
+                               std::vector<double> &y) const;
+
+  /**
+   * 要素数量，包含三角形的要素按读取顺序编号，每个要素的三角形在三角形表中连续存放
+   */
+  [[nodiscard]] size_t FeaturesNum() const { return feature_fids_.size(); }
+
+  /**
+   * 每个要素的FID
+   */
+  [[nodiscard]] const std::vector<int64_t> &FeatureFids() const { return feature_fids_; }
+
+  /**
+   * 每个要素attribute_field字段的值，未指定字段时为空，字段值为空的要素取0
+   */
+  [[nodiscard]] const std::vector<double> &FeatureValues() const { return feature_values_; }
+
+  /**
+   * 按要素生成随机点：第i个要素生成counts[i]个点，要素内按三角形面积均匀分布，
+   * 各要素的点依次连续生成，通过store(要素序号, 数量, x数组, y数组)分批输出
+   */
+  template<typename URNG, typename Store>
+  void GenFeaturePoints(URNG &engine, const std::vector<size_t> &counts, Store &&store) const;
+
   [[nodiscard]]  static Rings ReadPolygonCoords(OGRPolygon *);
 
+  /**
+   * 将几何对象分解为多边形坐标数组追加到rings_array，
+   * 多部件几何递归分解，曲线多边形先线性化
+   */
+  static void AppendGeometryRings(OGRGeometry *geometry, double curve_step_degrees, RingsArray &rings_array);
+
  private:
-  PolygonArray polygon_array_;
-  RingsArray polygon_rings_array_;
-  PolygonTriangulationAray polygon_triangulation_aray_;
-  PolygonTriangleAreaAccArray polygon_triangle_area_acc_array_;
-  std::vector<std::vector<Point>> polygon_vertices_array_;
-  // 多个多边形扁平化后的顶点坐标数组
-  std::vector<double> polygon_area_acc_array_;
+  // 所有多边形三角剖分得到的三角形，按多边形顺序连续存放，指向triangles_storage_或缓存文件映射
+  const Triangle *triangles_{};
+  size_t triangles_num_{};
+  std::vector<Triangle> triangles_storage_;
+  std::unique_ptr<ROICache> cache_;
+  // 按面积选择三角形的别名表
+  AliasTable triangle_alias_table_;
+  // 每个要素第一个三角形在triangles_中的索引，最后一项为三角形总数
+  std::vector<size_t> feature_triangle_offsets_;
+  // 每个要素的FID及属性字段值
+  std::vector<int64_t> feature_fids_;
+  std::vector<double> feature_values_;
+
+  // 等积模式下多边形的坐标系及等积投影坐标系，非等积模式为空
+  std::unique_ptr<OGRSpatialReference> source_srs_;
+  std::unique_ptr<OGRSpatialReference> equal_area_srs_;
+  // 区分不同ROI对象，线程缓存的坐标转换依据此编号判断是否属于当前ROI
+  uint64_t id_;
 
   // random engine
   std::mt19937 rand_engine_{std::random_device{}()};
-  // random distribution
-  std::uniform_real_distribution<double> rand_zero_one_{0.0, 1.0};
-  std::uniform_int_distribution<int> random_polygon_index_;
 
   /**
-   * 查找数组当中值等于或第一个小于指定值(target)的项索引
-   * 使用二分查找法实现
+   * 建立等积投影并将多边形坐标转换到等积投影坐标系
+   */
+  void ProjectToEqualArea(OGRSpatialReference *source_srs, RingsArray &rings_array);
+
+  /**
+   * 将等积投影坐标批量转换回多边形坐标系，每个线程使用各自的坐标转换对象
+   */
+  void InverseProject(size_t n, double *x, double *y) const;
+
+  /**
+   * 读取多边形并进行三角剖分
+   */
+  void Triangulate(const std::string &roi_path, const ROIOptions &options);
+
+  /**
+   * 要素内按面积选择三角形的别名表，要素面积为0时抛出异常
+   */
+  [[nodiscard]] AliasTable FeatureAliasTable(size_t feature_index) const;
+
+  /**
+   * 依据重心坐标生成三角形内的点，u、v为[0, 1)区间均匀随机数
    */
-  [[nodiscard]]  static int FindLowerOrEqualIndex(const std::vector<double> &arr, double target);
+  static Point PointInTriangle(const Triangle &triangle, double u, double v) {
+    if (u + v > 1) {
+      u = 1 - u;
+      v = 1 - v;
+    }
+    return {
+        u * (triangle.p3[0] - triangle.p1[0]) + v * (triangle.p2[0] - triangle.p1[0]) + triangle.p1[0],
+        u * (triangle.p3[1] - triangle.p1[1]) + v * (triangle.p2[1] - triangle.p1[1]) + triangle.p1[1],
+    };
+  }
+
+  // 批量生成时每批点数量，每批的中间结果保存在栈上
+  static constexpr size_t kGenerateBatchSize = 256;
+
+  /**
+   * 分批生成随机点，每批先通过alias_table抽取triangles中的三角形并查找顶点，再统一计算重心坐标，
+   * 计算结果通过store(偏移, 数量, x数组, y数组)输出
+   */
+  template<typename URNG, typename Store>
+  void GenRandomPointsBatched(URNG &engine,
+                              size_t n,
+                              const AliasTable &alias_table,
+                              const Triangle *triangles,
+                              Store &&store) const;
 };
 
+template<typename URNG>
+std::array<double, 2> ROI::GenRandomPoint(URNG &engine) const {
+  double random[kRandomNumbersPerPoint];
+  FillUniform(engine, random, kRandomNumbersPerPoint);
+  // 按面积随机选择用于生成随机点的三角形
+  const auto &triangle = triangles_[triangle_alias_table_.Sample(random[0])];
+  // 依据三角形重心坐标原理生成三角形内随机点
+  auto point = PointInTriangle(triangle, random[1], random[2]);
+  if (equal_area_srs_ != nullptr) {
+    InverseProject(1, &point[0], &point[1]);
+  }
+  return point;
+}
+
+template<typename URNG>
+void ROI::GenRandomPoints(URNG &engine, size_t n, double *xy) const {
+  GenRandomPointsBatched(engine, n, triangle_alias_table_, triangles_, [xy](size_t offset, size_t count, const double *x, const double *y) {
+    double *out = xy + offset * 2;
+    for (size_t i = 0; i != count; ++i) {
+      out[i * 2] = x[i];
+      out[i * 2 + 1] = y[i];
+    }
+  });
+}
+
+template<typename URNG>
+void ROI::GenRandomPoints(URNG &engine, size_t n, double *x, double *y) const {
+  GenRandomPointsBatched(engine, n, triangle_alias_table_, triangles_,
+                         [x, y](size_t offset, size_t count, const double *batch_x, const double *batch_y) {
+                           std::copy(batch_x, batch_x + count, x + offset);
+                           std::copy(batch_y, batch_y + count, y + offset);
+                         });
+}
+
+template<typename URNG, typename Store>
+void ROI::GenFeaturePoints(URNG &engine, const std::vector<size_t> &counts, Store &&store) const {
+  if (counts.size() != FeaturesNum()) {
+    throw std::invalid_argument("点数量与要素数量不一致");
+  }
+  for (size_t feature_index = 0; feature_index != counts.size(); ++feature_index) {
+    if (counts[feature_index] == 0) {
+      continue;
+    }
+    // 每个要素只建立一次别名表，要素的全部点连续生成
+    auto alias_table = FeatureAliasTable(feature_index);
+    GenRandomPointsBatched(engine, counts[feature_index], alias_table, triangles_ + feature_triangle_offsets_[feature_index],
+                           [&store, feature_index](size_t, size_t count, const double *x, const double *y) {
+                             store(feature_index, count, x, y);
+                           });
+  }
+}
+
+template<typename URNG, typename Store>
+void ROI::GenRandomPointsBatched(URNG &engine,
+                                 size_t n,
+                                 const AliasTable &alias_table,
+                                 const Triangle *triangles,
+                                 Store &&store) const {
+  double random[kGenerateBatchSize * kRandomNumbersPerPoint];
+  double p1_x[kGenerateBatchSize], p1_y[kGenerateBatchSize];
+  double p2_x[kGenerateBatchSize], p2_y[kGenerateBatchSize];
+  double p3_x[kGenerateBatchSize], p3_y[kGenerateBatchSize];
+  double u[kGenerateBatchSize], v[kGenerateBatchSize];
+  double x[kGenerateBatchSize], y[kGenerateBatchSize];
+
+  for (size_t offset = 0; offset < n; offset += kGenerateBatchSize) {
+    size_t count = std::min(kGenerateBatchSize, n - offset);
+
+    // 整批抽取随机数再查找三角形顶点，每个点依次使用3个随机数，顺序与GenRandomPoint相同
+    FillUniform(engine, random, count * kRandomNumbersPerPoint);
+    for (size_t i = 0; i != count; ++i) {
+      const double *point_random = random + i * kRandomNumbersPerPoint;
+      const auto &triangle = triangles[alias_table.Sample(point_random[0])];
+      u[i] = point_random[1];
+      v[i] = point_random[2];
+
+      p1_x[i] = triangle.p1[0];
+      p1_y[i] = triangle.p1[1];
+      p2_x[i] = triangle.p2[0];
+      p2_y[i] = triangle.p2[1];
+      p3_x[i] = triangle.p3[0];
+      p3_y[i] = triangle.p3[1];
+    }
+
+    // 依据三角形重心坐标原理生成三角形内随机点，无分支以便编译器向量化
+    for (size_t i = 0; i != count; ++i) {
+      bool flip = u[i] + v[i] > 1;
+      double a = flip ? 1 - u[i] : u[i];
+      double b = flip ? 1 - v[i] : v[i];
+      x[i] = a * (p3_x[i] - p1_x[i]) + b * (p2_x[i] - p1_x[i]) + p1_x[i];
+      y[i] = a * (p3_y[i] - p1_y[i]) + b * (p2_y[i] - p1_y[i]) + p1_y[i];
+    }
+
+    if (equal_area_srs_ != nullptr) {
+      InverseProject(count, x, y);
+    }
+    store(offset, count, x, y);
+  }
+}
+
 /**
- * 计算三角形面积
+ * 计算三角形面积，使用以第一个顶点为原点的两条边的叉积
  */
 [[nodiscard]] double CalculateTriangleArea(double x1, double y1, double x2, double y2, double x3, double y3);
+
+/**
+ * 批量计算n个三角形的面积写入areas
+ */
+void CalculateTriangleAreas(const ROI::Triangle *triangles, size_t n, double *areas);
+
+/**
+ * 按权重将n个点系统分配给各项：权重累加轴上等间隔、统一偏移offset(以间隔为单位，[0, 1)区间)的n个位置，
+ * 每个位置计入所在的项，各项的点数量与期望值相差不超过1，总数恰好为n
+ */
+[[nodiscard]] std::vector<size_t> AllocatePointsByWeight(size_t n, const std::vector<double> &weights, double offset);
@@ -0,0 +1,286 @@
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cpl_string.h>
+#include <cpl_vsi.h>
+#include <gdal_priv.h>
+
+#include "roi_cache.h"
+
+using namespace std::string_literals;
+
+namespace {
+
+// 文件格式或三角剖分结果的计算方法变化时修改版本号，旧缓存自动失效
+constexpr char kMagic[8] = {'R', 'O', 'I', 'C', 'A', 'C', 'H', 'E'};
+constexpr uint32_t kVersion = 5;
+// 用于检查字节序
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr uint64_t kAlignment = 64;
+
+static_assert(std::is_trivially_copyable<ROI::Triangle>::value && sizeof(ROI::Triangle) == 6 * sizeof(double),
+              "三角形需要能够直接映射");
+static_assert(std::is_trivially_copyable<AliasTable::Entry>::value && sizeof(AliasTable::Entry) == 16,
+              "别名表项需要能够直接映射");
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order_mark;
+  uint64_t key_offset;
+  uint64_t key_size;
+  uint64_t source_srs_wkt_offset;
+  uint64_t source_srs_wkt_size;
+  uint64_t equal_area_srs_wkt_offset;
+  uint64_t equal_area_srs_wkt_size;
+  uint64_t triangles_offset;
+  uint64_t triangles_num;
+  uint64_t alias_entries_offset;
+  uint64_t features_num;
+  uint64_t feature_triangle_offsets_offset;
+  uint64_t feature_fids_offset;
+  uint64_t feature_values_offset;
+  uint64_t feature_values_num;
+  uint64_t file_size;
+};
+
+uint64_t Align(uint64_t offset) {
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+/**
+ * FNV-1a 64位哈希
+ */
+uint64_t Hash(const std::string &text) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (auto c: text) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/**
+ * 文件的修改时间(纳秒精度)及大小，文件不存在时返回false
+ */
+bool AppendFileStat(const std::string &file, std::string &key) {
+  VSIStatBufL stat_buf;
+  if (VSIStatL(file.c_str(), &stat_buf) != 0) {
+    return false;
+  }
+  char buffer[96];
+  std::snprintf(buffer, sizeof(buffer), "\n%" PRId64 ".%09ld\n%" PRIu64,
+                static_cast<int64_t>(stat_buf.st_mtim.tv_sec),
+                static_cast<long>(stat_buf.st_mtim.tv_nsec),
+                static_cast<uint64_t>(stat_buf.st_size));
+  key += '\n';
+  key += file;
+  key += buffer;
+  return true;
+}
+
+void WriteAt(std::ofstream &stream, uint64_t offset, const void *data, size_t size) {
+  stream.seekp(static_cast<std::streamoff>(offset));
+  stream.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+}
+
+}
+
+ROICache::~ROICache() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+  }
+}
+
+std::string ROICache::Key(const std::string &roi_path, const ROIOptions &options) {
+  std::string path = roi_path;
+  std::error_code error_code;
+  auto canonical_path = std::filesystem::weakly_canonical(roi_path, error_code);
+  if (!error_code && std::filesystem::exists(canonical_path, error_code)) {
+    path = canonical_path.string();
+  }
+
+  std::string key = path;
+  if (!AppendFileStat(roi_path, key)) {
+    return {};
+  }
+  // 属性字段值等保存在其他文件中(如Shapefile的.dbf)，这些文件修改后缓存同样需要失效
+  std::unique_ptr<GDALDataset> dataset{(GDALDataset *) GDALOpenEx(roi_path.c_str(), GDAL_OF_VECTOR, nullptr, nullptr,
+                                                                  nullptr)};
+  if (dataset != nullptr) {
+    char **files = dataset->GetFileList();
+    for (char **file = files; file != nullptr && *file != nullptr; ++file) {
+      if (roi_path != *file && !AppendFileStat(*file, key)) {
+        CSLDestroy(files);
+        return {};
+      }
+    }
+    CSLDestroy(files);
+  }
+
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "\n%.17g\n%d\n", options.curve_step_degrees, options.equal_area ? 1 : 0);
+  return key + buffer + options.attribute_field;
+}
+
+std::string ROICache::Path(const std::string &cache_dir, const std::string &key) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016" PRIx64 ".roicache", Hash(key));
+  return (std::filesystem::path(cache_dir) / name).string();
+}
+
+std::unique_ptr<ROICache> ROICache::Open(const std::string &cache_path, const std::string &key) {
+  int fd = open(cache_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat file_stat{};
+  if (fstat(fd, &file_stat) != 0 || static_cast<uint64_t>(file_stat.st_size) < sizeof(Header)) {
+    close(fd);
+    return nullptr;
+  }
+  auto file_size = static_cast<size_t>(file_stat.st_size);
+  void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return nullptr;
+  }
+
+  std::unique_ptr<ROICache> cache{new ROICache};
+  cache->mapping_ = mapping;
+  cache->mapping_size_ = file_size;
+
+  const auto *data = static_cast<const char *>(mapping);
+  Header header{};
+  std::memcpy(&header, data, sizeof(Header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion
+      || header.byte_order_mark != kByteOrderMark || header.file_size != file_size || header.triangles_num == 0) {
+    return nullptr;
+  }
+  // 各数据段需位于文件范围内
+  auto in_file = [file_size](uint64_t offset, uint64_t count, uint64_t item_size) {
+    return offset <= file_size && count <= (file_size - offset) / item_size;
+  };
+  if (!in_file(header.key_offset, header.key_size, 1)
+      || !in_file(header.source_srs_wkt_offset, header.source_srs_wkt_size, 1)
+      || !in_file(header.equal_area_srs_wkt_offset, header.equal_area_srs_wkt_size, 1)
+      || !in_file(header.triangles_offset, header.triangles_num, sizeof(ROI::Triangle))
+      || !in_file(header.alias_entries_offset, header.triangles_num, sizeof(AliasTable::Entry))
+      || header.features_num == 0
+      || !in_file(header.feature_triangle_offsets_offset, header.features_num + 1, sizeof(uint64_t))
+      || !in_file(header.feature_fids_offset, header.features_num, sizeof(int64_t))
+      || (header.feature_values_num != 0 && header.feature_values_num != header.features_num)
+      || !in_file(header.feature_values_offset, header.feature_values_num, sizeof(double))) {
+    return nullptr;
+  }
+  if (header.key_size != key.size() || std::memcmp(data + header.key_offset, key.data(), key.size()) != 0) {
+    return nullptr;
+  }
+
+  // 文件内容被截断或损坏时，别名及要素三角形索引可能越界，加载时检查一次，不符合时丢弃缓存重新剖分
+  const auto *alias_entries = reinterpret_cast<const AliasTable::Entry *>(data + header.alias_entries_offset);
+  for (uint64_t i = 0; i != header.triangles_num; ++i) {
+    const auto &entry = alias_entries[i];
+    if (entry.alias >= header.triangles_num || !(entry.probability >= 0 && entry.probability <= 1)) {
+      return nullptr;
+    }
+  }
+  const auto *feature_triangle_offsets = reinterpret_cast<const uint64_t *>(data + header.feature_triangle_offsets_offset);
+  if (feature_triangle_offsets[0] != 0 || feature_triangle_offsets[header.features_num] != header.triangles_num) {
+    return nullptr;
+  }
+  for (uint64_t i = 0; i != header.features_num; ++i) {
+    if (feature_triangle_offsets[i] > feature_triangle_offsets[i + 1]) {
+      return nullptr;
+    }
+  }
+
+  cache->source_srs_wkt_.assign(data + header.source_srs_wkt_offset, header.source_srs_wkt_size);
+  cache->equal_area_srs_wkt_.assign(data + header.equal_area_srs_wkt_offset, header.equal_area_srs_wkt_size);
+  cache->triangles_ = reinterpret_cast<const ROI::Triangle *>(data + header.triangles_offset);
+  cache->triangles_num_ = header.triangles_num;
+  cache->alias_entries_ = alias_entries;
+  cache->feature_triangle_offsets_ = feature_triangle_offsets;
+  cache->features_num_ = header.features_num;
+  cache->feature_fids_ = reinterpret_cast<const int64_t *>(data + header.feature_fids_offset);
+  if (header.feature_values_num != 0) {
+    cache->feature_values_ = reinterpret_cast<const double *>(data + header.feature_values_offset);
+  }
+  return cache;
+}
+
+void ROICache::Write(const std::string &cache_path,
+                     const std::string &key,
+                     const ROI::Triangle *triangles,
+                     size_t triangles_num,
+                     const AliasTable &alias_table,
+                     const std::vector<size_t> &feature_triangle_offsets,
+                     const std::vector<int64_t> &feature_fids,
+                     const std::vector<double> &feature_values,
+                     const std::string &source_srs_wkt,
+                     const std::string &equal_area_srs_wkt) {
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byte_order_mark = kByteOrderMark;
+  header.key_offset = sizeof(Header);
+  header.key_size = key.size();
+  header.source_srs_wkt_offset = header.key_offset + header.key_size;
+  header.source_srs_wkt_size = source_srs_wkt.size();
+  header.equal_area_srs_wkt_offset = header.source_srs_wkt_offset + header.source_srs_wkt_size;
+  header.equal_area_srs_wkt_size = equal_area_srs_wkt.size();
+  header.triangles_offset = Align(header.equal_area_srs_wkt_offset + header.equal_area_srs_wkt_size);
+  header.triangles_num = triangles_num;
+  header.alias_entries_offset = Align(header.triangles_offset + triangles_num * sizeof(ROI::Triangle));
+  header.features_num = feature_fids.size();
+  header.feature_triangle_offsets_offset =
+      Align(header.alias_entries_offset + triangles_num * sizeof(AliasTable::Entry));
+  header.feature_fids_offset =
+      Align(header.feature_triangle_offsets_offset + feature_triangle_offsets.size() * sizeof(uint64_t));
+  // 没有属性字段值时该数据段为空，不对齐，保证文件以最后写入的数据结束
+  header.feature_values_offset = header.feature_fids_offset + feature_fids.size() * sizeof(int64_t);
+  if (!feature_values.empty()) {
+    header.feature_values_offset = Align(header.feature_values_offset);
+  }
+  header.feature_values_num = feature_values.size();
+  header.file_size = header.feature_values_offset + feature_values.size() * sizeof(double);
+
+  std::filesystem::create_directories(std::filesystem::path(cache_path).parent_path());
+  auto temp_path = cache_path + "." + std::to_string(std::random_device{}()) + ".tmp";
+  {
+    std::ofstream stream{temp_path, std::ios::binary | std::ios::trunc};
+    if (!stream) {
+      throw std::runtime_error("无法创建缓存文件："s + temp_path);
+    }
+    std::vector<uint64_t> offsets(feature_triangle_offsets.cbegin(), feature_triangle_offsets.cend());
+    WriteAt(stream, 0, &header, sizeof(Header));
+    WriteAt(stream, header.key_offset, key.data(), key.size());
+    WriteAt(stream, header.source_srs_wkt_offset, source_srs_wkt.data(), source_srs_wkt.size());
+    WriteAt(stream, header.equal_area_srs_wkt_offset, equal_area_srs_wkt.data(), equal_area_srs_wkt.size());
+    WriteAt(stream, header.triangles_offset, triangles, triangles_num * sizeof(ROI::Triangle));
+    WriteAt(stream, header.alias_entries_offset, alias_table.Entries(), triangles_num * sizeof(AliasTable::Entry));
+    WriteAt(stream, header.feature_triangle_offsets_offset, offsets.data(), offsets.size() * sizeof(uint64_t));
+    WriteAt(stream, header.feature_fids_offset, feature_fids.data(), feature_fids.size() * sizeof(int64_t));
+    WriteAt(stream, header.feature_values_offset, feature_values.data(), feature_values.size() * sizeof(double));
+    if (!stream.flush()) {
+      stream.close();
+      std::remove(temp_path.c_str());
+      throw std::runtime_error("写入缓存文件失败："s + temp_path);
+    }
+  }
+  if (std::rename(temp_path.c_str(), cache_path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    throw std::runtime_error("写入缓存文件失败："s + cache_path);
+  }
+}
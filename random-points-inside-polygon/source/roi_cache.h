@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "roi.h"
+
+/**
+ * ROI三角剖分结果的磁盘缓存
+ * 缓存文件依次保存文件头、缓存键、等积模式坐标系、三角形表、别名表、要素三角形索引、要素FID及属性字段值，各数据段64字节对齐，
+ * 读取时通过mmap映射，三角形表及别名表直接使用映射内存，不复制
+ */
+class ROICache {
+ public:
+  ~ROICache();
+
+  ROICache(const ROICache &) = delete;
+  ROICache &operator=(const ROICache &) = delete;
+
+  /**
+   * 缓存键：多边形文件路径，数据集包含的各文件(GetFileList()，如Shapefile的.shp、.shx、.dbf、.prj)的路径、
+   * 纳秒精度的修改时间及文件大小，以及影响缓存内容的选项(曲线线性化角度、等积模式、属性字段)，
+   * 无法获取文件信息时返回空字符串，表示不使用缓存
+   */
+  static std::string Key(const std::string &roi_path, const ROIOptions &options);
+
+  /**
+   * 缓存文件路径：缓存目录下以缓存键哈希值命名的文件
+   */
+  static std::string Path(const std::string &cache_dir, const std::string &key);
+
+  /**
+   * 映射缓存文件，文件不存在、格式不符、缓存键不一致或别名表、要素三角形索引越界时返回nullptr
+   */
+  static std::unique_ptr<ROICache> Open(const std::string &cache_path, const std::string &key);
+
+  /**
+   * 写入缓存文件，先写入临时文件再重命名，避免其他进程读取到不完整的文件
+   */
+  static void Write(const std::string &cache_path,
+                    const std::string &key,
+                    const ROI::Triangle *triangles,
+                    size_t triangles_num,
+                    const AliasTable &alias_table,
+                    const std::vector<size_t> &feature_triangle_offsets,
+                    const std::vector<int64_t> &feature_fids,
+                    const std::vector<double> &feature_values,
+                    const std::string &source_srs_wkt,
+                    const std::string &equal_area_srs_wkt);
+
+  [[nodiscard]] const ROI::Triangle *Triangles() const { return triangles_; }
+  [[nodiscard]] size_t TrianglesNum() const { return triangles_num_; }
+  [[nodiscard]] const AliasTable::Entry *AliasEntries() const { return alias_entries_; }
+  // 要素三角形索引比要素数量多一项(三角形总数)
+  [[nodiscard]] const uint64_t *FeatureTriangleOffsets() const { return feature_triangle_offsets_; }
+  [[nodiscard]] size_t FeaturesNum() const { return features_num_; }
+  [[nodiscard]] const int64_t *FeatureFids() const { return feature_fids_; }
+  // 未指定属性字段时为nullptr
+  [[nodiscard]] const double *FeatureValues() const { return feature_values_; }
+  // 等积模式下多边形的坐标系及等积投影坐标系
+  [[nodiscard]] const std::string &SourceSrsWkt() const { return source_srs_wkt_; }
+  [[nodiscard]] const std::string &EqualAreaSrsWkt() const { return equal_area_srs_wkt_; }
+
+ private:
+  ROICache() = default;
+
+  void *mapping_{};
+  size_t mapping_size_{};
+  const ROI::Triangle *triangles_{};
+  size_t triangles_num_{};
+  const AliasTable::Entry *alias_entries_{};
+  const uint64_t *feature_triangle_offsets_{};
+  size_t features_num_{};
+  const int64_t *feature_fids_{};
+  const double *feature_values_{};
+  std::string source_srs_wkt_;
+  std::string equal_area_srs_wkt_;
+};
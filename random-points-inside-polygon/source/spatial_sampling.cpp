@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "roi.h"
+#include "low_discrepancy.h"
+#include "splitmix.h"
+
+using namespace std::string_literals;
+
+namespace {
+
+// 泊松圆盘抽样连续放置失败次数达到该值时认为ROI已饱和
+constexpr size_t kPoissonDiskMaxFailures = 10000;
+// 空间哈希网格行列号的最大绝对值，检查邻近网格时行列号会再加减2
+constexpr double kMaxCellIndex = INT32_MAX - 2;
+
+std::mt19937_64 CreateEngine(uint64_t seed) {
+  std::seed_seq seed_seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+  return std::mt19937_64{seed_seq};
+}
+
+double Cross(const ROI::Point &a, const ROI::Point &b, const ROI::Point &c) {
+  return (b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]);
+}
+
+/**
+ * 点是否位于三角形内(含边界)，与顶点顺序无关
+ */
+bool TriangleContains(const ROI::Triangle &triangle, const ROI::Point &point) {
+  double d1 = Cross(triangle.p1, triangle.p2, point);
+  double d2 = Cross(triangle.p2, triangle.p3, point);
+  double d3 = Cross(triangle.p3, triangle.p1, point);
+  bool has_negative = d1 < 0 || d2 < 0 || d3 < 0;
+  bool has_positive = d1 > 0 || d2 > 0 || d3 > 0;
+  return !(has_negative && has_positive);
+}
+
+/**
+ * 三角形与水平条带y ∈ [y0, y1]的交集(凸多边形)的x范围，交集为空时返回false
+ * 交集的顶点为条带内的三角形顶点及各边与条带上下边界的交点
+ */
+bool TriangleSlabXRange(const ROI::Triangle &triangle, double y0, double y1, double &min_x, double &max_x) {
+  min_x = std::numeric_limits<double>::infinity();
+  max_x = -std::numeric_limits<double>::infinity();
+  const ROI::Point *vertices[3] = {&triangle.p1, &triangle.p2, &triangle.p3};
+  for (int i = 0; i != 3; ++i) {
+    const auto &a = *vertices[i], &b = *vertices[(i + 1) % 3];
+    // 边a + t * (b - a)位于条带内的参数范围[t0, t1]
+    double t0 = 0, t1 = 1;
+    if (a[1] == b[1]) {
+      if (a[1] < y0 || a[1] > y1) {
+        continue;
+      }
+    } else {
+      double ta = (y0 - a[1]) / (b[1] - a[1]), tb = (y1 - a[1]) / (b[1] - a[1]);
+      t0 = std::max(t0, std::min(ta, tb));
+      t1 = std::min(t1, std::max(ta, tb));
+      if (t0 > t1) {
+        continue;
+      }
+    }
+    double x0 = a[0] + t0 * (b[0] - a[0]), x1 = a[0] + t1 * (b[0] - a[0]);
+    min_x = std::min({min_x, x0, x1});
+    max_x = std::max({max_x, x0, x1});
+  }
+  return min_x <= max_x;
+}
+
+/**
+ * 网格行列号合并为空间哈希的键，行列号需在int32_t范围内
+ */
+uint64_t CellKey(int64_t column, int64_t row) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(column)) << 32) | static_cast<uint32_t>(row);
+}
+
+/**
+ * 网格空间哈希，开放寻址线性探测，键为网格行列号，值为点索引
+ */
+class CellHash {
+ public:
+  explicit CellHash(size_t expected_size) {
+    size_t capacity = 1024;
+    while (capacity < expected_size * 2) {
+      capacity *= 2;
+    }
+    slots_.resize(capacity);
+  }
+
+  /**
+   * 返回网格中的点索引，网格为空时返回kEmpty
+   */
+  [[nodiscard]] uint32_t Find(uint64_t key) const {
+    for (size_t i = Slot(key);; i = (i + 1) & (slots_.size() - 1)) {
+      const auto &slot = slots_[i];
+      if (slot.value == kEmpty || slot.key == key) {
+        return slot.value;
+      }
+    }
+  }
+
+  void Insert(uint64_t key, uint32_t value) {
+    if ((size_ + 1) * 2 > slots_.size()) {
+      Grow();
+    }
+    for (size_t i = Slot(key);; i = (i + 1) & (slots_.size() - 1)) {
+      auto &slot = slots_[i];
+      if (slot.value == kEmpty || slot.key == key) {
+        size_ += slot.value == kEmpty ? 1 : 0;
+        slot = Entry{key, value};
+        return;
+      }
+    }
+  }
+
+  static constexpr uint32_t kEmpty = UINT32_MAX;
+
+ private:
+  struct Entry {
+    uint64_t key{};
+    uint32_t value{kEmpty};
+  };
+
+  std::vector<Entry> slots_;
+  size_t size_{};
+
+  [[nodiscard]] size_t Slot(uint64_t key) const {
+    return static_cast<size_t>(SplitMix64(key)) & (slots_.size() - 1);
+  }
+
+  void Grow() {
+    std::vector<Entry> old_slots(slots_.size() * 2);
+    old_slots.swap(slots_);
+    size_ = 0;
+    for (const auto &slot: old_slots) {
+      if (slot.value != kEmpty) {
+        Insert(slot.key, slot.value);
+      }
+    }
+  }
+};
+
+}
+
+void ROI::GenStratifiedPoints(size_t n, uint64_t seed, std::vector<double> &x, std::vector<double> &y) const {
+  x.resize(n);
+  y.resize(n);
+  if (n == 0) {
+    return;
+  }
+  std::vector<double> areas(triangles_num_);
+  CalculateTriangleAreas(triangles_, triangles_num_, areas.data());
+  double total_area = std::accumulate(areas.cbegin(), areas.cend(), 0.0);
+
+  auto engine = CreateEngine(seed);
+  std::uniform_real_distribution<double> rand_zero_one{0.0, 1.0};
+  double step = total_area / static_cast<double>(n);
+  double offset = rand_zero_one(engine);
+
+  // 第i个点位于面积累加轴上(i + offset) * step处，依次推进三角形
+  size_t triangle_index = 0;
+  double area_acc = areas[0];
+  for (size_t i = 0; i != n; ++i) {
+    double position = (static_cast<double>(i) + offset) * step;
+    while (position >= area_acc && triangle_index + 1 < triangles_num_) {
+      area_acc += areas[++triangle_index];
+    }
+    double u = rand_zero_one(engine), v = rand_zero_one(engine);
+    auto point = PointInTriangle(triangles_[triangle_index], u, v);
+    x[i] = point[0];
+    y[i] = point[1];
+  }
+
+  if (equal_area_srs_ != nullptr) {
+    InverseProject(n, x.data(), y.data());
+  }
+}
+
+void ROI::GenJitteredGridPoints(size_t n, uint64_t seed, std::vector<double> &x, std::vector<double> &y) const {
+  x.clear();
+  y.clear();
+  if (n == 0) {
+    return;
+  }
+  std::vector<double> areas(triangles_num_);
+  CalculateTriangleAreas(triangles_, triangles_num_, areas.data());
+  double total_area = std::accumulate(areas.cbegin(), areas.cend(), 0.0);
+  double cell_size = std::sqrt(total_area / static_cast<double>(n));
+  x.reserve(n + n / 8);
+  y.reserve(n + n / 8);
+
+  // 逐行遍历每个三角形覆盖的网格，每行只遍历三角形在该行内的x范围，遍历的网格数量与三角形面积及周长成正比，
+  // 狭长三角形不会遍历整个外包矩形。网格随机点位于三角形内时输出，
+  // 相邻三角形共用同一网格时随机点相同，只会被包含它的三角形输出
+  for (size_t t = 0; t != triangles_num_; ++t) {
+    if (!(areas[t] > 0)) {
+      continue;
+    }
+    const auto &triangle = triangles_[t];
+    double min_x = std::min({triangle.p1[0], triangle.p2[0], triangle.p3[0]});
+    double max_x = std::max({triangle.p1[0], triangle.p2[0], triangle.p3[0]});
+    double min_y = std::min({triangle.p1[1], triangle.p2[1], triangle.p3[1]});
+    double max_y = std::max({triangle.p1[1], triangle.p2[1], triangle.p3[1]});
+    auto column_min = static_cast<int64_t>(std::floor(min_x / cell_size));
+    auto column_max = static_cast<int64_t>(std::floor(max_x / cell_size));
+    auto row_begin = static_cast<int64_t>(std::floor(min_y / cell_size));
+    auto row_end = static_cast<int64_t>(std::floor(max_y / cell_size));
+    // 条带的x范围向两侧放宽，避免舍入误差漏掉边界上的网格
+    double margin = (max_x - min_x) * 1e-12 + cell_size * 1e-9;
+    for (int64_t row = row_begin; row <= row_end; ++row) {
+      double slab_min_x, slab_max_x;
+      if (!TriangleSlabXRange(triangle, static_cast<double>(row) * cell_size,
+                              static_cast<double>(row + 1) * cell_size, slab_min_x, slab_max_x)) {
+        continue;
+      }
+      auto column_begin = std::max(column_min, static_cast<int64_t>(std::floor((slab_min_x - margin) / cell_size)));
+      auto column_end = std::min(column_max, static_cast<int64_t>(std::floor((slab_max_x + margin) / cell_size)));
+      for (int64_t column = column_begin; column <= column_end; ++column) {
+        uint64_t hash = SplitMix64(seed ^ SplitMix64(static_cast<uint64_t>(column) ^ SplitMix64(static_cast<uint64_t>(row))));
+        Point point{
+            (static_cast<double>(column) + ToUnitDouble(hash)) * cell_size,
+            (static_cast<double>(row) + ToUnitDouble(SplitMix64(hash))) * cell_size,
+        };
+        if (TriangleContains(triangle, point)) {
+          x.push_back(point[0]);
+          y.push_back(point[1]);
+        }
+      }
+    }
+  }
+
+  if (equal_area_srs_ != nullptr) {
+    InverseProject(x.size(), x.data(), y.data());
+  }
+}
+
+void ROI::GenPoissonDiskPoints(size_t n,
+                               double min_distance,
+                               uint64_t seed,
+                               std::vector<double> &x,
+                               std::vector<double> &y) const {
+  if (!(min_distance > 0)) {
+    throw std::invalid_argument("泊松圆盘抽样的最小距离必须大于0"s);
+  }
+  x.clear();
+  y.clear();
+
+  // 网格边长为min_distance / sqrt(2)，每个网格最多包含一个点，只需检查周围5x5个网格
+  double cell_size = min_distance / std::sqrt(2.0);
+  double min_distance_squared = min_distance * min_distance;
+  CellHash grid{std::min<size_t>(n, 1 << 24)};
+
+  auto engine = CreateEngine(seed);
+  std::uniform_real_distribution<double> rand_zero_one{0.0, 1.0};
+  size_t failures = 0;
+  while (x.size() < n && failures < kPoissonDiskMaxFailures) {
+    const auto &triangle = triangles_[triangle_alias_table_.Sample(rand_zero_one(engine))];
+    double u = rand_zero_one(engine), v = rand_zero_one(engine);
+    auto point = PointInTriangle(triangle, u, v);
+
+    double column_value = std::floor(point[0] / cell_size), row_value = std::floor(point[1] / cell_size);
+    if (std::abs(column_value) > kMaxCellIndex || std::abs(row_value) > kMaxCellIndex) {
+      throw std::invalid_argument("泊松圆盘抽样的最小距离相对于坐标值过小"s);
+    }
+    auto column = static_cast<int64_t>(column_value);
+    auto row = static_cast<int64_t>(row_value);
+    bool accepted = true;
+    for (int64_t r = row - 2; accepted && r <= row + 2; ++r) {
+      for (int64_t c = column - 2; c <= column + 2; ++c) {
+        auto found = grid.Find(CellKey(c, r));
+        if (found == CellHash::kEmpty) {
+          continue;
+        }
+        double dx = x[found] - point[0];
+        double dy = y[found] - point[1];
+        if (dx * dx + dy * dy < min_distance_squared) {
+          accepted = false;
+          break;
+        }
+      }
+    }
+    if (!accepted) {
+      ++failures;
+      continue;
+    }
+    failures = 0;
+    grid.Insert(CellKey(column, row), static_cast<uint32_t>(x.size()));
+    x.push_back(point[0]);
+    y.push_back(point[1]);
+  }
+
+  if (equal_area_srs_ != nullptr) {
+    InverseProject(x.size(), x.data(), y.data());
+  }
+}
+
+void ROI::GenLowDiscrepancyPoints(const LowDiscrepancySequence &sequence,
+                                  size_t n,
+                                  std::vector<double> &x,
+                                  std::vector<double> &y) const {
+  x.resize(n);
+  y.resize(n);
+  if (n == 0) {
+    return;
+  }
+  // 别名表会打乱序列第1维的分布，改为在面积累加值上二分查找，保持相邻取值对应相邻的三角形
+  std::vector<double> area_acc(triangles_num_);
+  CalculateTriangleAreas(triangles_, triangles_num_, area_acc.data());
+  std::partial_sum(area_acc.cbegin(), area_acc.cend(), area_acc.begin());
+  double total_area = area_acc.back();
+
+  double values[LowDiscrepancySequence::kDimensions];
+  for (size_t i = 0; i != n; ++i) {
+    sequence.Sample(i, values);
+    auto triangle_index = static_cast<size_t>(
+        std::upper_bound(area_acc.cbegin(), area_acc.cend(), values[0] * total_area) - area_acc.cbegin());
+    auto point = PointInTriangle(triangles_[std::min(triangle_index, triangles_num_ - 1)], values[1], values[2]);
+    x[i] = point[0];
+    y[i] = point[1];
+  }
+
+  if (equal_area_srs_ != nullptr) {
+    InverseProject(n, x.data(), y.data());
+  }
+}
+
+std::vector<size_t> AllocatePointsByWeight(size_t n, const std::vector<double> &weights, double offset) {
+  std::vector<size_t> counts(weights.size());
+  if (n == 0) {
+    return counts;
+  }
+  double total_weight = 0;
+  for (auto weight: weights) {
+    if (!(weight >= 0) || std::isinf(weight)) {
+      throw std::invalid_argument("权重必须为非负数"s);
+    }
+    total_weight += weight;
+  }
+  if (!(total_weight > 0)) {
+    throw std::invalid_argument("权重总和必须大于0"s);
+  }
+
+  // 权重累加值为c之前的位置数量为ceil(c / step - offset)，各项的点数量为其两端位置数量之差
+  double step = total_weight / static_cast<double>(n);
+  double weight_acc = 0;
+  size_t allocated = 0;
+  for (size_t i = 0; i != weights.size(); ++i) {
+    weight_acc += weights[i];
+    double positions = std::ceil(weight_acc / step - offset);
+    size_t end = positions <= 0 ? 0 : std::min(n, static_cast<size_t>(positions));
+    end = std::max(end, allocated);
+    counts[i] = end - allocated;
+    allocated = end;
+  }
+  // 舍入误差导致总数不足时计入最后一个权重大于0的项
+  if (allocated < n) {
+    size_t last = weights.size();
+    while (!(weights[--last] > 0)) {}
+    counts[last] += n - allocated;
+  }
+  return counts;
+}
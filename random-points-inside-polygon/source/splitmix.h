@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * SplitMix64混合函数，将64位整数打散为均匀分布的64位哈希值
+ */
+inline uint64_t SplitMix64(uint64_t value) {
+  value += 0x9e3779b97f4a7c15ULL;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
+/**
+ * 64位随机数高53位转换为[0, 1)区间的double
+ */
+inline double ToUnitDouble(uint64_t value) {
+  return static_cast<double>(value >> 11) * 0x1.0p-53;
+}
@@ -0,0 +1,81 @@
+#include <cmath>
+
+#include "roi.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TRIANGLE_AREA_X86
+#include <immintrin.h>
+#define TRIANGLE_AREA_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+static_assert(sizeof(ROI::Triangle) == 6 * sizeof(double), "三角形顶点坐标需连续存放");
+
+void CalculateTriangleAreasScalar(const ROI::Triangle *triangles, size_t n, double *areas) {
+  for (size_t i = 0; i != n; ++i) {
+    const auto &triangle = triangles[i];
+    areas[i] = CalculateTriangleArea(
+        triangle.p1[0], triangle.p1[1],
+        triangle.p2[0], triangle.p2[1],
+        triangle.p3[0], triangle.p3[1]);
+  }
+}
+
+#ifdef TRIANGLE_AREA_X86
+
+const bool kHasAvx2 = []() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+}();
+
+/**
+ * 两个三角形(12个double)的三条边向量，返回[d2x_a, d2y_a, d2x_b, d2y_b]与[d3y_a, d3x_a, d3y_b, d3x_b]的乘积
+ */
+TRIANGLE_AREA_TARGET_AVX2 inline __m256d CrossTerms(const double *coords) {
+  // v0 = [x1a y1a x2a y2a], v1 = [x3a y3a x1b y1b], v2 = [x2b y2b x3b y3b]
+  __m256d v0 = _mm256_loadu_pd(coords);
+  __m256d v1 = _mm256_loadu_pd(coords + 4);
+  __m256d v2 = _mm256_loadu_pd(coords + 8);
+  __m256d p1 = _mm256_blend_pd(v0, v1, 0b1100);
+  __m256d p2 = _mm256_permute2f128_pd(v0, v2, 0x21);
+  __m256d p3 = _mm256_blend_pd(v1, v2, 0b1100);
+  __m256d d2 = _mm256_sub_pd(p2, p1);
+  __m256d d3 = _mm256_sub_pd(p3, p1);
+  return _mm256_mul_pd(d2, _mm256_permute_pd(d3, 0b0101));
+}
+
+TRIANGLE_AREA_TARGET_AVX2 void CalculateTriangleAreasAvx2(const ROI::Triangle *triangles, size_t n, double *areas) {
+  const auto *coords = reinterpret_cast<const double *>(triangles);
+  const __m256d sign_mask = _mm256_set1_pd(-0.0);
+  const __m256d half = _mm256_set1_pd(0.5);
+  size_t i = 0;
+  // 每次计算4个三角形
+  for (; i + 4 <= n; i += 4) {
+    __m256d terms_ab = CrossTerms(coords + i * 6);
+    __m256d terms_cd = CrossTerms(coords + i * 6 + 12);
+    // [a, c, b, d] -> [a, b, c, d]
+    __m256d cross = _mm256_permute4x64_pd(_mm256_hsub_pd(terms_ab, terms_cd), 0b11011000);
+    _mm256_storeu_pd(areas + i, _mm256_mul_pd(_mm256_andnot_pd(sign_mask, cross), half));
+  }
+  CalculateTriangleAreasScalar(triangles + i, n - i, areas + i);
+}
+
+#endif
+
+}
+
+double CalculateTriangleArea(double x1, double y1, double x2, double y2, double x3, double y3) {
+  // 以第一个顶点为原点可减小坐标值较大时的舍入误差，狭长三角形也不会得到NaN
+  return std::abs((x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1)) * 0.5;
+}
+
+void CalculateTriangleAreas(const ROI::Triangle *triangles, size_t n, double *areas) {
+#ifdef TRIANGLE_AREA_X86
+  if (kHasAvx2) {
+    CalculateTriangleAreasAvx2(triangles, n, areas);
+    return;
+  }
+#endif
+  CalculateTriangleAreasScalar(triangles, n, areas);
+}
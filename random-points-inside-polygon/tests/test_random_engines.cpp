@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../source/random_engines.h"
+
+namespace {
+
+int failures = 0;
+
+void Check(bool condition, const char *name, const char *message) {
+  if (!condition) {
+    std::fprintf(stderr, "失败：%s：%s\n", name, message);
+    ++failures;
+  }
+}
+
+constexpr RandomEngineType kEngineTypes[] = {
+    RandomEngineType::kMt19937_64,
+    RandomEngineType::kXoshiro256PlusPlus,
+    RandomEngineType::kPcg64,
+    RandomEngineType::kBatched,
+    RandomEngineType::kPhilox,
+};
+
+constexpr const char *kEngineNames[] = {"mt19937_64", "xoshiro256pp", "pcg64", "batched", "philox"};
+
+/**
+ * 2^22个[0, 1)区间随机数的均值、方差及1024个等宽区间的卡方统计量，种子固定，结果确定
+ * 阈值取各统计量在理想均匀分布下约6倍标准差的范围
+ */
+void TestUniformity(RandomEngineType type, const char *name) {
+  constexpr size_t kSamples = size_t{1} << 22;
+  constexpr size_t kBins = 1024;
+  std::seed_seq seed_seq{20240601};
+  WithRandomEngine(type, seed_seq, [&](auto &engine) {
+    std::vector<double> values(4096);
+    std::vector<size_t> histogram(kBins);
+    double sum = 0, square_sum = 0;
+    bool in_range = true;
+    for (size_t generated = 0; generated != kSamples; generated += values.size()) {
+      FillUniform(engine, values.data(), values.size());
+      for (double value: values) {
+        in_range = in_range && value >= 0 && value < 1;
+        histogram[std::min(kBins - 1, static_cast<size_t>(value * kBins))]++;
+        sum += value;
+        square_sum += value * value;
+      }
+    }
+    double mean = sum / kSamples;
+    double variance = square_sum / kSamples - mean * mean;
+    double expected = static_cast<double>(kSamples) / kBins;
+    double chi_square = 0;
+    for (auto count: histogram) {
+      chi_square += (count - expected) * (count - expected) / expected;
+    }
+    // 均值标准差sqrt(1/12/N)，方差标准差sqrt(1/180/N)，卡方统计量均值kBins-1、标准差sqrt(2(kBins-1))
+    double mean_z = (mean - 0.5) / std::sqrt(1.0 / 12 / kSamples);
+    double variance_z = (variance - 1.0 / 12) / std::sqrt(1.0 / 180 / kSamples);
+    double chi_square_z = (chi_square - (kBins - 1)) / std::sqrt(2.0 * (kBins - 1));
+    std::printf("%-12s 均值 %.6f (z=%+.2f)  方差 %.6f (z=%+.2f)  卡方 %.1f (z=%+.2f)\n",
+                name, mean, mean_z, variance, variance_z, chi_square, chi_square_z);
+    Check(in_range, name, "随机数应在[0, 1)区间");
+    Check(std::abs(mean_z) < 6, name, "均值偏离0.5");
+    Check(std::abs(variance_z) < 6, name, "方差偏离1/12");
+    Check(std::abs(chi_square_z) < 6, name, "卡方检验不通过");
+  });
+}
+
+/**
+ * Random123的Philox4x64-10已知答案：密钥与计数器均为0
+ */
+void TestPhiloxKnownAnswer() {
+  const uint64_t key[2] = {0, 0};
+  const uint64_t expected[4] = {0x16554d9eca36314cULL, 0xdb20fe9d672d0fdcULL,
+                                0xd7e772cee186176bULL, 0x7e68b68aec7ba23bULL};
+  uint64_t result[4];
+  Philox4x64::Block(key, 0, result);
+  Check(std::memcmp(result, expected, sizeof(expected)) == 0, "philox", "与已知答案不一致");
+
+  // 逐个生成与Seek定位得到的随机数相同
+  Philox4x64 sequential{0, 0}, seeking{0, 0};
+  bool same = true;
+  for (uint64_t position = 0; position != 64; ++position) {
+    uint64_t value = sequential();
+    seeking.Seek(position);
+    same = same && seeking() == value;
+  }
+  Check(same, "philox", "Seek后的随机数与逐个生成的不一致");
+  Check(Philox4x64(0, 0)() == expected[0], "philox", "第一个随机数应为第一个分组的第一个分量");
+}
+
+/**
+ * FillUniform与逐个调用operator()使用相同的随机数序列，跨越缓冲区边界时也相同
+ */
+void TestBatchedFillUniform() {
+  std::seed_seq seed_seq_a{7}, seed_seq_b{7};
+  BatchedUniformGenerator filled{seed_seq_a}, single{seed_seq_b};
+  std::vector<double> values;
+  bool same = true;
+  for (size_t n: {1, 3, 1000, 1024, 2500, 17}) {
+    values.resize(n);
+    filled.FillUniform(values.data(), n);
+    for (size_t i = 0; i != n; ++i) {
+      uint64_t mantissa = (single() >> 12) | 0x3ff0000000000000ULL;
+      double value;
+      std::memcpy(&value, &mantissa, sizeof(double));
+      same = same && values[i] == value - 1.0;
+    }
+  }
+  Check(same, "batched", "FillUniform与operator()的结果不一致");
+}
+
+void TestParseRandomEngineType() {
+  for (size_t i = 0; i != std::size(kEngineTypes); ++i) {
+    Check(ParseRandomEngineType(kEngineNames[i]) == kEngineTypes[i], kEngineNames[i], "名称解析错误");
+  }
+  bool thrown = false;
+  try {
+    ParseRandomEngineType("unknown");
+  } catch (const std::invalid_argument &) {
+    thrown = true;
+  }
+  Check(thrown, "unknown", "不支持的名称应抛出异常");
+}
+
+}
+
+int main() {
+  for (size_t i = 0; i != std::size(kEngineTypes); ++i) {
+    TestUniformity(kEngineTypes[i], kEngineNames[i]);
+  }
+  TestPhiloxKnownAnswer();
+  TestBatchedFillUniform();
+  TestParseRandomEngineType();
+  if (failures != 0) {
+    return 1;
+  }
+  std::printf("全部通过\n");
+  return 0;
+}
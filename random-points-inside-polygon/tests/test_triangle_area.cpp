@@ -0,0 +1,98 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../source/roi.h"
+
+namespace {
+
+int failures = 0;
+
+void Check(bool condition, const char *message) {
+  if (!condition) {
+    std::fprintf(stderr, "失败：%s\n", message);
+    ++failures;
+  }
+}
+
+ROI::Triangle MakeTriangle(double x1, double y1, double x2, double y2, double x3, double y3) {
+  ROI::Triangle triangle{};
+  triangle.p1 = {x1, y1};
+  triangle.p2 = {x2, y2};
+  triangle.p3 = {x3, y3};
+  return triangle;
+}
+
+double ScalarArea(const ROI::Triangle &triangle) {
+  return CalculateTriangleArea(triangle.p1[0], triangle.p1[1],
+                               triangle.p2[0], triangle.p2[1],
+                               triangle.p3[0], triangle.p3[1]);
+}
+
+/**
+ * 共线的三个顶点面积为0
+ */
+void TestCollinear() {
+  Check(CalculateTriangleArea(0, 0, 1, 1, 2, 2) == 0, "共线三角形面积应为0");
+  Check(CalculateTriangleArea(1e6, 1e6, 1e6 + 1, 1e6 + 1, 1e6 + 3, 1e6 + 3) == 0, "坐标较大的共线三角形面积应为0");
+  Check(CalculateTriangleArea(5, 5, 5, 5, 5, 5) == 0, "三个顶点重合时面积应为0");
+}
+
+/**
+ * 底边宽2e6、高1e-6、面积为1的狭长三角形，海伦公式在此情况下得到0或NaN
+ */
+void TestSliver() {
+  std::vector<ROI::Triangle> triangles{
+      MakeTriangle(-1e6, 0, 1e6, 0, 0, 1e-6),
+      MakeTriangle(4e6, 0, 6e6, 0, 5e6, 1e-6),
+      MakeTriangle(0, 0, 2e6, 1e-6, 1e6, 1.5e-6),
+  };
+  for (const auto &triangle: triangles) {
+    double area = ScalarArea(triangle);
+    Check(std::isfinite(area) && std::abs(area - 1) < 1e-6, "狭长三角形面积应为1");
+  }
+  std::vector<double> areas(triangles.size());
+  CalculateTriangleAreas(triangles.data(), triangles.size(), areas.data());
+  for (double area: areas) {
+    Check(std::isfinite(area) && std::abs(area - 1) < 1e-6, "批量计算的狭长三角形面积应为1");
+  }
+}
+
+/**
+ * 批量计算(支持时使用AVX2，每次4个三角形，剩余的逐个计算)与逐个计算的结果完全相同，
+ * 数量不是4的倍数时不写出areas[n]
+ */
+void TestBatchMatchesScalar() {
+  std::mt19937_64 engine{1};
+  std::uniform_real_distribution<double> coordinate{-1e6, 1e6};
+  for (size_t n = 0; n != 23; ++n) {
+    std::vector<ROI::Triangle> triangles(n);
+    for (auto &triangle: triangles) {
+      triangle = MakeTriangle(coordinate(engine), coordinate(engine),
+                              coordinate(engine), coordinate(engine),
+                              coordinate(engine), coordinate(engine));
+    }
+    std::vector<double> areas(n + 1, -1.0);
+    CalculateTriangleAreas(triangles.data(), n, areas.data());
+    bool same = true;
+    for (size_t i = 0; i != n; ++i) {
+      same = same && areas[i] == ScalarArea(triangles[i]);
+    }
+    Check(same, "批量计算结果应与逐个计算相同");
+    Check(areas[n] == -1.0, "批量计算不应写出数组末尾之后的元素");
+  }
+}
+
+}
+
+int main() {
+  TestCollinear();
+  TestSliver();
+  TestBatchMatchesScalar();
+  if (failures != 0) {
+    return 1;
+  }
+  std::printf("全部通过\n");
+  return 0;
+}